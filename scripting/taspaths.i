@@ -53,6 +53,9 @@
 %template(ArrayReal4) std::array<double, 4>;
 %template(VectorPairRealReal) std::vector<std::pair<double, double>>;
 %template(VectorArrayReal4) std::vector<std::array<double, 4>>;
+%template(VectorReal) std::vector<double>;
+%template(VectorSize) std::vector<std::size_t>;
+%template(VectorBool) std::vector<bool>;
 //%template(VectorVec) std::vector<t_vec>;
 
 %include "src/core/types.h"
@@ -61,6 +64,7 @@
 %include "src/core/Instrument.h"
 %include "src/core/InstrumentSpace.h"
 %include "src/core/PathsBuilder.h"
+%template(VectorInstrumentPath) std::vector<InstrumentPath>;
 %include "src/core/PathsExporter.h"
 %include "src/core/TasCalculator.h"
 //%include "tlibs2/libs/maths.h"
@@ -418,23 +418,23 @@ void Axis::TrafosNeedUpdate() const
 void Axis::UpdateTrafos() const
 {
 	// trafo of previous axis
-	t_mat matPrev = m_prev ? m_prev->GetTrafo(AxisAngle::OUTGOING) : tl2::unit<t_mat>(4);
+	t_mat44 matPrev = m_prev ? m_prev->GetTrafo(AxisAngle::OUTGOING) : tl2::unit<t_mat44>(4);
 
 	// local trafos
-	const t_vec upaxis = tl2::create<t_vec>({0, 0, 1});
-	t_mat matRotIn = tl2::hom_rotation<t_mat, t_vec>(upaxis, m_angle_in);
-	t_mat matTrans = tl2::hom_translation<t_mat, t_real>(m_pos[0], m_pos[1], 0.);
+	const t_vec4 upaxis = tl2::create<t_vec4>({0, 0, 1, 0});
+	t_mat44 matRotIn = tl2::hom_rotation<t_mat44, t_vec4>(upaxis, m_angle_in);
+	t_mat44 matTrans = tl2::hom_translation<t_mat44, t_real>(m_pos[0], m_pos[1], 0.);
 	m_trafoIncoming = matPrev * matTrans * matRotIn;
 
-	t_mat matRotInternal = tl2::hom_rotation<t_mat, t_vec>(upaxis, m_angle_internal);
+	t_mat44 matRotInternal = tl2::hom_rotation<t_mat44, t_vec4>(upaxis, m_angle_internal);
 	m_trafoInternal = m_trafoIncoming * matRotInternal;
 
-	t_mat matRotOut = tl2::hom_rotation<t_mat, t_vec>(upaxis, m_angle_out);
+	t_mat44 matRotOut = tl2::hom_rotation<t_mat44, t_vec4>(upaxis, m_angle_out);
 	m_trafoOutgoing = m_trafoIncoming * matRotOut;
 }
 
 
-const t_mat& Axis::GetTrafo(AxisAngle which) const
+const t_mat44& Axis::GetTrafo(AxisAngle which) const
 {
 	if(m_trafos_need_update)
 	{
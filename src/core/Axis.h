@@ -106,7 +106,7 @@ public:
 	void SetAxisAngleOutSpeed(t_real speed);
 
 	// which==1: in, which==2: internal, which==3: out
-	const t_mat& GetTrafo(AxisAngle which=AxisAngle::INCOMING) const;
+	const t_mat44& GetTrafo(AxisAngle which=AxisAngle::INCOMING) const;
 	void UpdateTrafos() const;
 	void TrafosNeedUpdate() const;
 
@@ -131,9 +131,9 @@ private:
 	Instrument *m_instr = nullptr;
 
 	// trafo matrices
-	mutable t_mat m_trafoIncoming = tl2::unit<t_mat>(4);
-	mutable t_mat m_trafoInternal = tl2::unit<t_mat>(4);
-	mutable t_mat m_trafoOutgoing = tl2::unit<t_mat>(4);
+	mutable t_mat44 m_trafoIncoming = tl2::unit<t_mat44>(4);
+	mutable t_mat44 m_trafoInternal = tl2::unit<t_mat44>(4);
+	mutable t_mat44 m_trafoOutgoing = tl2::unit<t_mat44>(4);
 	mutable bool m_trafos_need_update = true;
 
 	// coordinate origin
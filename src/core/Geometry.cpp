@@ -70,7 +70,7 @@ Geometry::~Geometry()
 }
 
 
-const t_mat& Geometry::GetTrafo() const
+const t_mat44& Geometry::GetTrafo() const
 {
 	if(m_trafo_needs_update)
 	{
@@ -290,7 +290,7 @@ void BoxGeometry::UpdateTrafo() const
 	//using namespace tl2_ops;
 	//std::cout << vecFrom << " -> " << vecTo << std::endl;
 
-	m_trafo = tl2::get_arrow_matrix<t_vec, t_mat, t_real>(
+	m_trafo = tl2::get_arrow_matrix<t_vec, t_mat44, t_real>(
 		vecTo, 1., postTranslate, vecFrom, 1., preTranslate, &upDir);
 
 	//std::cout << tl2::det<t_mat>(m_trafo) << std::endl;
@@ -464,7 +464,7 @@ pt::ptree CylinderGeometry::Save() const
 
 void CylinderGeometry::UpdateTrafo() const
 {
-	m_trafo = tl2::hom_translation<t_mat, t_real>(m_pos[0], m_pos[1], m_pos[2] + m_height*0.5);
+	m_trafo = tl2::hom_translation<t_mat44, t_real>(m_pos[0], m_pos[1], m_pos[2] + m_height*0.5);
 }
 
 
@@ -611,7 +611,7 @@ pt::ptree SphereGeometry::Save() const
 
 void SphereGeometry::UpdateTrafo() const
 {
-	m_trafo = tl2::hom_translation<t_mat, t_real>(m_pos[0], m_pos[1], m_pos[2] + m_radius*0.5);
+	m_trafo = tl2::hom_translation<t_mat44, t_real>(m_pos[0], m_pos[1], m_pos[2] + m_radius*0.5);
 }
 
 
@@ -86,7 +86,7 @@ public:
 	virtual boost::property_tree::ptree Save() const;
 
 	virtual void UpdateTrafo() const = 0;
-	virtual const t_mat& GetTrafo() const;
+	virtual const t_mat44& GetTrafo() const;
 	virtual std::tuple<std::vector<t_vec>, std::vector<t_vec>, std::vector<t_vec>>
 		GetTriangles() const = 0;
 
@@ -116,7 +116,7 @@ protected:
 	std::string m_texture{};
 
 	mutable bool m_trafo_needs_update = true;
-	mutable t_mat m_trafo = tl2::unit<t_mat>(4);
+	mutable t_mat44 m_trafo = tl2::unit<t_mat44>(4);
 };
 // ----------------------------------------------------------------------------
 
@@ -25,6 +25,10 @@
 
 #include <unordered_map>
 #include <optional>
+#include <span>
+#include <atomic>
+
+#include <boost/function_output_iterator.hpp>
 
 #include "InstrumentSpace.h"
 #include "src/libs/lines.h"
@@ -39,6 +43,7 @@ namespace pt = boost::property_tree;
 InstrumentSpace::InstrumentSpace()
 	: m_sigUpdate{std::make_shared<t_sig_update>()}
 {
+	InstrumentChanged();
 }
 
 
@@ -67,6 +72,9 @@ const InstrumentSpace& InstrumentSpace::operator=(const InstrumentSpace& instr)
 	this->m_floorcol = instr.m_floorcol;
 
 	this->m_walls = instr.m_walls;
+	this->m_walls_version = instr.m_walls_version;
+	this->m_walls_scene = instr.m_walls_scene;
+	this->m_instr_version = instr.m_instr_version;
 	this->m_instr = instr.m_instr;
 
 	this->m_drag_pos_axis_start = instr.m_drag_pos_axis_start;
@@ -88,6 +96,8 @@ void InstrumentSpace::Clear()
 	// clear
 	m_walls.clear();
 	m_instr.Clear();
+	WallsChanged();
+	InstrumentChanged();
 
 	// remove listeners
 	m_sigUpdate = std::make_shared<t_sig_update>();
@@ -141,6 +151,7 @@ bool InstrumentSpace::Load(const pt::ptree& prop)
 	bool instr_ok = false;
 	if(auto instr = prop.get_child_optional("instrument"); instr)
 		instr_ok = m_instr.Load(*instr);
+	InstrumentChanged();
 
 	return instr_ok;
 }
@@ -192,6 +203,8 @@ void InstrumentSpace::AddWall(const std::vector<std::shared_ptr<Geometry>>& wall
 			wallseg->SetId(id);
 		m_walls.push_back(wallseg);
 	}
+
+	WallsChanged();
 }
 
 
@@ -207,6 +220,7 @@ bool InstrumentSpace::DeleteObject(const std::string& id)
 	}); iter != m_walls.end())
 	{
 		m_walls.erase(iter);
+		WallsChanged();
 		return true;
 	}
 
@@ -248,6 +262,7 @@ std::tuple<bool, std::shared_ptr<Geometry>> InstrumentSpace::RotateObject(const
 	}); iter != m_walls.end())
 	{
 		(*iter)->Rotate(angle);
+		WallsChanged();
 		return std::make_tuple(true, *iter);
 	}
 
@@ -287,254 +302,381 @@ bool InstrumentSpace::CheckAngularLimits() const
 }
 
 
+// ----------------------------------------------------------------------------
+// functions to extract object geometries
+// ----------------------------------------------------------------------------
 /**
- * check for collisions, using a 2d representation of the instrument space
+ * extract circle from cylinder and sphere geometry
  */
-bool InstrumentSpace::CheckCollision2D() const
+static bool get_comp_circles(
+	const std::shared_ptr<Geometry>& comp,
+	std::tuple<t_vec2, t_real>& circle,
+	const t_mat44* matAxis = nullptr)
 {
-	// ------------------------------------------------------------------------
-	// functions to extract object geometries
-	// ------------------------------------------------------------------------
-	// extract circle from cylinder and sphere geometry
-	auto get_comp_circles = [](
-		const std::shared_ptr<Geometry>& comp,
-		std::tuple<t_vec, t_real>& circle,
-		const t_mat* matAxis = nullptr)
-	{
-		const t_mat& matGeo = comp->GetTrafo();
-		t_mat mat = matAxis ? (*matAxis) * matGeo : matGeo;
+	t_real rad = 0;
 
-		if(comp->GetType() == GeometryType::CYLINDER)
-		{
-			auto cyl = std::dynamic_pointer_cast<CylinderGeometry>(comp);
+	if(comp->GetType() == GeometryType::CYLINDER)
+		rad = static_cast<const CylinderGeometry&>(*comp).GetRadius();
+	else if(comp->GetType() == GeometryType::SPHERE)
+		rad = static_cast<const SphereGeometry&>(*comp).GetRadius();
+	else
+		return false;
 
-			// position already considered in trafo matrix
-			t_vec pos = tl2::create<t_vec>({0,0,0,1}); //cyl->GetPos();
-			t_real rad = cyl->GetRadius();
+	const t_mat44& matGeo = comp->GetTrafo();
+	t_mat44 mat = matAxis ? (*matAxis) * matGeo : matGeo;
 
-			// trafo in homogeneous coordinates
-			if(pos.size() < 4)
-				pos.push_back(1);
-			pos = mat * pos;
+	// position already considered in trafo matrix
+	t_vec4 pos = mat * tl2::create<t_vec4>({0, 0, 0, 1});
 
-			// only two dimensions needed
-			pos.resize(2);
+	// only two dimensions needed
+	std::get<0>(circle) = tl2::create<t_vec2>({pos[0], pos[1]});
+	std::get<1>(circle) = rad;
 
-			std::get<0>(circle) = pos;
-			std::get<1>(circle) = rad;
-		}
-		else if(comp->GetType() == GeometryType::SPHERE)
-		{
-			auto sph = std::dynamic_pointer_cast<SphereGeometry>(comp);
+	return true;
+}
 
-			// position already considered in trafo matrix
-			t_vec pos = tl2::create<t_vec>({0,0,0,1}); //sph->GetPos();
-			t_real rad = sph->GetRadius();
 
-			// trafo in homogeneous coordinates
-			if(pos.size() < 4)
-				pos.push_back(1);
-			pos = mat * pos;
+/**
+ * extract 2d polygon from box geometry
+ */
+static bool get_comp_polys(
+	const std::shared_ptr<Geometry>& comp,
+	std::vector<t_vec2>& poly,
+	const t_mat44* matAxis = nullptr)
+{
+	if(comp->GetType() != GeometryType::BOX)
+		return false;
 
-			// only two dimensions needed
-			pos.resize(2);
+	const BoxGeometry& box = static_cast<const BoxGeometry&>(*comp);
 
-			std::get<0>(circle) = pos;
-			std::get<1>(circle) = rad;
-		}
+	t_real lx = box.GetLength() * t_real(0.5);
+	t_real ly = box.GetDepth() * t_real(0.5);
+	t_real lz = box.GetHeight() * t_real(0.5);
+
+	const t_mat44& matGeo = comp->GetTrafo();
+	t_mat44 mat = matAxis ? (*matAxis) * matGeo : matGeo;
+
+	const t_vec4 vertices[] =
+	{
+		tl2::create<t_vec4>({ +lx, -ly, -lz, 1 }),	// vertex 0
+		tl2::create<t_vec4>({ -lx, -ly, -lz, 1 }),	// vertex 1
+		tl2::create<t_vec4>({ -lx, +ly, -lz, 1 }),	// vertex 2
+		tl2::create<t_vec4>({ +lx, +ly, -lz, 1 }),	// vertex 3
 	};
 
+	poly.clear();
+	poly.reserve(std::size(vertices));
 
-	// extract circles from cylinder and sphere geometries
-	auto get_comps_circles = [&get_comp_circles](
-		const std::vector<std::shared_ptr<Geometry>>& comps,
-		std::vector<std::tuple<t_vec, t_real>>& circles,
-		const t_mat* matAxis = nullptr)
+	for(const t_vec4& vertex : vertices)
 	{
-		circles.reserve(circles.size() + comps.size());
+		t_vec4 vec = mat * vertex;
 
-		for(const auto& comp : comps)
+		// only two dimensions needed
+		poly.emplace_back(tl2::create<t_vec2>({vec[0], vec[1]}));
+	}
+
+	return true;
+}
+// ----------------------------------------------------------------------------
+
+
+/**
+ * flatten the wall geometries into 2d primitives
+ */
+std::shared_ptr<const WallsCollisionScene> InstrumentSpace::GetWallsCollisionScene() const
+{
+	// still up-to-date?
+	if(m_walls_scene && m_walls_scene->version == m_walls_version)
+		return m_walls_scene;
+
+	auto scene = std::make_shared<WallsCollisionScene>();
+	scene->version = m_walls_version;
+
+	for(const auto& wall : m_walls)
+	{
+		// wall polygons
+		if(std::vector<t_vec2> wallPoly; get_comp_polys(wall, wallPoly))
 		{
-			std::tuple<t_vec, t_real> circle;
-			get_comp_circles(comp, circle, matAxis);
+			scene->polys_bb.emplace_back(
+				tl2::bounding_box<t_vec2, std::vector>(wallPoly));
+			scene->polys.emplace_back(std::move(wallPoly));
+		}
 
-			if(std::get<0>(circle).size())
-				circles.emplace_back(std::move(circle));
+		// wall circles
+		if(std::tuple<t_vec2, t_real> wallCircle; get_comp_circles(wall, wallCircle))
+		{
+			scene->circles_bb.emplace_back(tl2::sphere_bounding_box<t_vec2>(
+				std::get<0>(wallCircle), std::get<1>(wallCircle)));
+			scene->circles.emplace_back(std::move(wallCircle));
 		}
-	};
+	}
 
+	scene->BuildIndexTrees();
 
-	auto get_circles = [&get_comps_circles](
-		const Axis& axis,
-		std::vector<std::tuple<t_vec, t_real>>& circles,
-		bool inc_incoming = true,
-		bool inc_internal = true,
-		bool inc_outgoing = true)
+	m_walls_scene = scene;
+	return scene;
+}
+
+
+/**
+ * invalidate the precompiled wall geometry
+ */
+void InstrumentSpace::WallsChanged()
+{
+	++m_walls_version;
+	m_walls_scene.reset();
+}
+
+
+/**
+ * assign a new unique version to the instrument,
+ * the ids are unique over all instrument spaces
+ */
+void InstrumentSpace::InstrumentChanged()
+{
+	static std::atomic<std::size_t> version_ctr{0};
+	m_instr_version = ++version_ctr;
+}
+
+
+// ----------------------------------------------------------------------------
+// precompiled wall geometry
+// ----------------------------------------------------------------------------
+/**
+ * build the index trees for the broad-phase collision checks
+ */
+void WallsCollisionScene::BuildIndexTrees()
+{
+	auto build_tree = [](const std::vector<std::tuple<t_vec2, t_vec2>>& bbs) -> t_idxtree
 	{
-		std::vector<AxisAngle> axisangles;
-		if(inc_incoming)
-			axisangles.push_back(AxisAngle::INCOMING);
-		if(inc_internal)
-			axisangles.push_back(AxisAngle::INTERNAL);
-		if(inc_outgoing)
-			axisangles.push_back(AxisAngle::OUTGOING);
+		std::vector<t_idxvalue> values;
+		values.reserve(bbs.size());
 
-		// get geometries relative to incoming, internal, and outgoing axis
-		for(AxisAngle axisangle : axisangles)
+		for(std::size_t idx=0; idx<bbs.size(); ++idx)
 		{
-			const t_mat& matAxis = axis.GetTrafo(axisangle);
-			get_comps_circles(axis.GetComps(axisangle), circles, &matAxis);
+			const auto& [bbmin, bbmax] = bbs[idx];
+			values.emplace_back(std::make_pair(t_idxbox{
+				t_idxvertex{bbmin[0], bbmin[1]},
+				t_idxvertex{bbmax[0], bbmax[1]}}, idx));
 		}
+
+		// use packed bulk-loading
+		return t_idxtree{values};
 	};
 
+	polys_tree = build_tree(polys_bb);
+	circles_tree = build_tree(circles_bb);
+}
+
 
-	// extract 2d polygon from box geometry
-	auto get_comp_polys = [](
-		const std::shared_ptr<Geometry>& comp,
-		std::vector<t_vec>& poly,
-		const t_mat* matAxis = nullptr)
+/**
+ * get the primitives of this scene which are not part of the other scene,
+ * e.g. to find the walls that have been added, moved or removed
+ */
+std::shared_ptr<WallsCollisionScene> WallsCollisionScene::GetDifference(
+	const WallsCollisionScene& other, t_real eps) const
+{
+	auto diff = std::make_shared<WallsCollisionScene>();
+
+	// is there a primitive with the given bounding box in the other scene fulfilling the predicate?
+	auto find_in_other = [](const t_idxtree& tree,
+		const std::tuple<t_vec2, t_vec2>& bb, t_real eps, const auto& pred) -> bool
 	{
-		const t_mat& matGeo = comp->GetTrafo();
-		t_mat mat = matAxis ? (*matAxis) * matGeo : matGeo;
+		const auto& [bbmin, bbmax] = bb;
+		t_idxbox box{
+			t_idxvertex{bbmin[0] - eps, bbmin[1] - eps},
+			t_idxvertex{bbmax[0] + eps, bbmax[1] + eps}};
+
+		bool found = false;
+		tree.query(boost::geometry::index::intersects(box),
+			boost::make_function_output_iterator([&found, &pred](const t_idxvalue& val)
+			{
+				if(!found)
+					found = pred(val.second);
+			}));
 
-		if(comp->GetType() == GeometryType::BOX)
-		{
-			auto cyl = std::dynamic_pointer_cast<BoxGeometry>(comp);
+		return found;
+	};
+
+	// polygons
+	for(std::size_t idx=0; idx<polys.size(); ++idx)
+	{
+		const std::vector<t_vec2>& poly = polys[idx];
 
-			t_real lx = cyl->GetLength() * t_real(0.5);
-			t_real ly = cyl->GetDepth() * t_real(0.5);
-			t_real lz = cyl->GetHeight() * t_real(0.5);
+		bool found = find_in_other(other.polys_tree, polys_bb[idx], eps,
+			[&poly, &other, eps](std::size_t otheridx) -> bool
+		{
+			const std::vector<t_vec2>& otherpoly = other.polys[otheridx];
+			if(otherpoly.size() != poly.size())
+				return false;
 
-			std::vector<t_vec> vertices =
+			for(std::size_t vertidx=0; vertidx<poly.size(); ++vertidx)
 			{
-				mat * tl2::create<t_vec>({ +lx, -ly, -lz, 1 }),	// vertex 0
-				mat * tl2::create<t_vec>({ -lx, -ly, -lz, 1 }),	// vertex 1
-				mat * tl2::create<t_vec>({ -lx, +ly, -lz, 1 }),	// vertex 2
-				mat * tl2::create<t_vec>({ +lx, +ly, -lz, 1 }),	// vertex 3
-			};
+				if(!tl2::equals<t_vec2>(poly[vertidx], otherpoly[vertidx], eps))
+					return false;
+			}
 
-			// only two dimensions needed
-			for(t_vec& vec : vertices)
-				vec.resize(2);
+			return true;
+		});
 
-			poly = std::move(vertices);
+		if(!found)
+		{
+			diff->polys.push_back(poly);
+			diff->polys_bb.push_back(polys_bb[idx]);
 		}
-	};
-
+	}
 
-	// extract 2d polygons from box geometries
-	auto get_comps_polys = [&get_comp_polys](
-		const std::vector<std::shared_ptr<Geometry>>& comps,
-		std::vector<std::vector<t_vec>>& polys,
-		const t_mat* matAxis = nullptr)
+	// circles
+	for(std::size_t idx=0; idx<circles.size(); ++idx)
 	{
-		polys.reserve(polys.size() + comps.size());
+		const auto& [pos, rad] = circles[idx];
 
-		for(const auto& comp : comps)
+		bool found = find_in_other(other.circles_tree, circles_bb[idx], eps,
+			[&pos, rad, &other, eps](std::size_t otheridx) -> bool
 		{
-			std::vector<t_vec> poly;
-			get_comp_polys(comp, poly, matAxis);
-			if(poly.size())
-				polys.emplace_back(std::move(poly));
+			const auto& [otherpos, otherrad] = other.circles[otheridx];
+
+			return tl2::equals<t_real>(rad, otherrad, eps) &&
+				tl2::equals<t_vec2>(pos, otherpos, eps);
+		});
+
+		if(!found)
+		{
+			diff->circles.push_back(circles[idx]);
+			diff->circles_bb.push_back(circles_bb[idx]);
 		}
-	};
+	}
 
+	diff->BuildIndexTrees();
+	return diff;
+}
+// ----------------------------------------------------------------------------
 
-	auto get_polys = [&get_comps_polys](
-		const Axis& axis,
-		std::vector<std::vector<t_vec>>& polys,
-		bool inc_incoming = true,
-		bool inc_internal = true,
-		bool inc_outgoing = true)
-	{
-		std::vector<AxisAngle> axisangles;
-		if(inc_incoming)
-			axisangles.push_back(AxisAngle::INCOMING);
-		if(inc_internal)
-			axisangles.push_back(AxisAngle::INTERNAL);
-		if(inc_outgoing)
-			axisangles.push_back(AxisAngle::OUTGOING);
 
-		// get geometries relative to incoming, internal, and outgoing axis
-		for(AxisAngle axisangle : axisangles)
+/**
+ * get the radius around the axis position that contains all its components,
+ * independently of the axis angles, since all axis trafos rotate around this position
+ */
+t_real InstrumentSpace::GetAxisReach2D(const Axis& axis)
+{
+	t_real reach = 0;
+
+	for(AxisAngle axisangle : { AxisAngle::INCOMING, AxisAngle::INTERNAL, AxisAngle::OUTGOING })
+	{
+		// components are given relative to the axis position
+		for(const auto& comp : axis.GetComps(axisangle))
 		{
-			const t_mat& matAxis = axis.GetTrafo(axisangle);
-			get_comps_polys(axis.GetComps(axisangle), polys, &matAxis);
+			if(std::tuple<t_vec2, t_real> circle; get_comp_circles(comp, circle))
+			{
+				reach = std::max(reach,
+					tl2::norm<t_vec2>(std::get<0>(circle)) + std::get<1>(circle));
+			}
+
+			if(std::vector<t_vec2> poly; get_comp_polys(comp, poly))
+			{
+				for(const t_vec2& vert : poly)
+					reach = std::max(reach, tl2::norm<t_vec2>(vert));
+			}
 		}
-	};
-	// ------------------------------------------------------------------------
+	}
+
+	return reach;
+}
 
 
+/**
+ * check for collisions, using a 2d representation of the instrument space
+ */
+bool InstrumentSpace::CheckCollision2D() const
+{
+	std::shared_ptr<const WallsCollisionScene> walls = GetWallsCollisionScene();
+	return CheckCollision2D(*walls, true);
+}
+
+
+/**
+ * check for collisions with the given walls and optionally for self-collisions
+ */
+bool InstrumentSpace::CheckCollision2D(const WallsCollisionScene& walls, bool check_self) const
+{
 	// ------------------------------------------------------------------------
-	// conversion from dynamic vectors to 2d arrays
+	// functions to extract object geometries
 	// ------------------------------------------------------------------------
-	auto convert_circle_2d = [](const std::tuple<t_vec, t_real>& circle)
-		-> std::optional<std::tuple<t_vec2, t_real>>
+	// extract circles from cylinder and sphere geometries
+	auto get_comps_circles = [](
+		const std::vector<std::shared_ptr<Geometry>>& comps,
+		std::vector<std::tuple<t_vec2, t_real>>& circles,
+		const t_mat44* matAxis = nullptr)
 	{
-		const t_vec& vec = std::get<0>(circle);
-
-		// invalid vertex
-		if(vec.size() < 2)
-			return std::nullopt;
+		circles.reserve(circles.size() + comps.size());
 
-		return std::make_tuple(
-			tl2::create<t_vec2>({vec[0], vec[1]}),
-			std::get<1>(circle));
+		for(const auto& comp : comps)
+		{
+			std::tuple<t_vec2, t_real> circle;
+			if(get_comp_circles(comp, circle, matAxis))
+				circles.emplace_back(std::move(circle));
+		}
 	};
 
 
-	auto convert_circles_2d = [&convert_circle_2d]
-		(const std::vector<std::tuple<t_vec, t_real>>& circles)
-		-> std::vector<std::tuple<t_vec2, t_real>>
+	auto get_circles = [&get_comps_circles](
+		const Axis& axis,
+		std::vector<std::tuple<t_vec2, t_real>>& circles,
+		bool inc_incoming = true,
+		bool inc_internal = true,
+		bool inc_outgoing = true)
 	{
-		std::vector<std::tuple<t_vec2, t_real>> circles2d;
-		circles2d.reserve(circles.size());
+		const AxisAngle axisangles[] = { AxisAngle::INCOMING, AxisAngle::INTERNAL, AxisAngle::OUTGOING };
+		const bool inc_axisangles[] = { inc_incoming, inc_internal, inc_outgoing };
 
-		for(const auto& circle : circles)
+		// get geometries relative to incoming, internal, and outgoing axis
+		for(std::size_t idx=0; idx<std::size(axisangles); ++idx)
 		{
-			auto circle2d = convert_circle_2d(circle);
-			if(circle2d)
-			circles2d.emplace_back(std::move(*circle2d));
-		}
+			if(!inc_axisangles[idx])
+				continue;
 
-		return circles2d;
+			const t_mat44& matAxis = axis.GetTrafo(axisangles[idx]);
+			get_comps_circles(axis.GetComps(axisangles[idx]), circles, &matAxis);
+		}
 	};
 
 
-	auto convert_poly_2d = [](const std::vector<t_vec> &poly)
-		-> std::optional<std::vector<t_vec2>>
+	// extract 2d polygons from box geometries
+	auto get_comps_polys = [](
+		const std::vector<std::shared_ptr<Geometry>>& comps,
+		std::vector<std::vector<t_vec2>>& polys,
+		const t_mat44* matAxis = nullptr)
 	{
-		std::vector<t_vec2> poly2d;
-		poly2d.reserve(poly.size());
+		polys.reserve(polys.size() + comps.size());
 
-		for(const t_vec& vec : poly)
+		for(const auto& comp : comps)
 		{
-			// invalid vertex
-			if(vec.size() < 2)
-				return std::nullopt;
-
-			poly2d.emplace_back(tl2::create<t_vec2>({vec[0], vec[1]}));
+			std::vector<t_vec2> poly;
+			if(get_comp_polys(comp, poly, matAxis))
+				polys.emplace_back(std::move(poly));
 		}
-
-		return poly2d;
 	};
 
 
-	auto convert_polys_2d = [&convert_poly_2d]
-		(const std::vector<std::vector<t_vec>> &polys)
-		-> std::vector<std::vector<t_vec2>>
+	auto get_polys = [&get_comps_polys](
+		const Axis& axis,
+		std::vector<std::vector<t_vec2>>& polys,
+		bool inc_incoming = true,
+		bool inc_internal = true,
+		bool inc_outgoing = true)
 	{
-		std::vector<std::vector<t_vec2>> polys2d;
-		polys2d.reserve(polys.size());
+		const AxisAngle axisangles[] = { AxisAngle::INCOMING, AxisAngle::INTERNAL, AxisAngle::OUTGOING };
+		const bool inc_axisangles[] = { inc_incoming, inc_internal, inc_outgoing };
 
-		for(const auto& poly : polys)
+		// get geometries relative to incoming, internal, and outgoing axis
+		for(std::size_t idx=0; idx<std::size(axisangles); ++idx)
 		{
-			auto poly2d = convert_poly_2d(poly);
-			if(poly2d)
-				polys2d.emplace_back(std::move(*poly2d));
-		}
+			if(!inc_axisangles[idx])
+				continue;
 
-		return polys2d;
+			const t_mat44& matAxis = axis.GetTrafo(axisangles[idx]);
+			get_comps_polys(axis.GetComps(axisangles[idx]), polys, &matAxis);
+		}
 	};
 	// ------------------------------------------------------------------------
 
@@ -544,8 +686,8 @@ bool InstrumentSpace::CheckCollision2D() const
 	// ------------------------------------------------------------------------
 	// check if two polygonal objects collide
 	auto check_collision_poly_poly = [this](
-		const std::vector<std::vector<t_vec2>>& polys1,
-		const std::vector<std::vector<t_vec2>>& polys2,
+		std::span<const std::vector<t_vec2>> polys1,
+		std::span<const std::vector<t_vec2>> polys2,
 		const std::tuple<t_vec2, t_vec2>& bb1,
 		const std::tuple<t_vec2, t_vec2>& bb2) -> bool
 	{
@@ -583,8 +725,8 @@ bool InstrumentSpace::CheckCollision2D() const
 
 	// check if two circular objects collide
 	auto check_collision_circle_circle = [](
-		const std::vector<std::tuple<t_vec2, t_real>>& circles1,
-		const std::vector<std::tuple<t_vec2, t_real>>& circles2) -> bool
+		std::span<const std::tuple<t_vec2, t_real>> circles1,
+		std::span<const std::tuple<t_vec2, t_real>> circles2) -> bool
 	{
 		for(std::size_t idx1=0; idx1<circles1.size(); ++idx1)
 		{
@@ -611,8 +753,8 @@ bool InstrumentSpace::CheckCollision2D() const
 
 	// check if a circular and a polygonal object collide
 	auto check_collision_circle_poly = [](
-		const std::vector<std::tuple<t_vec2, t_real>>& circles,
-		const std::vector<std::vector<t_vec2>>& polys,
+		std::span<const std::tuple<t_vec2, t_real>> circles,
+		std::span<const std::vector<t_vec2>> polys,
 		const std::tuple<t_vec2, t_vec2>& bbCircles,
 		const std::tuple<t_vec2, t_vec2>& bbPolys) -> bool
 	{
@@ -635,6 +777,55 @@ bool InstrumentSpace::CheckCollision2D() const
 
 		return false;
 	};
+
+
+	// ------------------------------------------------------------------------
+	// broad-phase queries
+	// ------------------------------------------------------------------------
+	// combine two bounding boxes
+	auto merge_bbs = [](
+		const std::tuple<t_vec2, t_vec2>& bb1,
+		const std::tuple<t_vec2, t_vec2>& bb2) -> std::tuple<t_vec2, t_vec2>
+	{
+		const auto& [min1, max1] = bb1;
+		const auto& [min2, max2] = bb2;
+
+		return std::make_tuple(
+			tl2::create<t_vec2>({ std::min(min1[0], min2[0]), std::min(min1[1], min2[1]) }),
+			tl2::create<t_vec2>({ std::max(max1[0], max2[0]), std::max(max1[1], max2[1]) }));
+	};
+
+
+	// call func for all wall primitives whose bounding boxes overlap with the given one,
+	// stop as soon as func reports a collision
+	auto query_walls = [](
+		const WallsCollisionScene::t_idxtree& tree,
+		const std::tuple<t_vec2, t_vec2>& bb,
+		const auto& func) -> bool
+	{
+		using t_idxvertex = WallsCollisionScene::t_idxvertex;
+		using t_idxbox = WallsCollisionScene::t_idxbox;
+
+		const auto& [bbmin, bbmax] = bb;
+
+		// empty bounding box
+		if(bbmin[0] > bbmax[0] || bbmin[1] > bbmax[1])
+			return false;
+
+		t_idxbox box{ t_idxvertex{bbmin[0], bbmin[1]}, t_idxvertex{bbmax[0], bbmax[1]} };
+
+		bool collides = false;
+		tree.query(boost::geometry::index::intersects(box),
+			boost::make_function_output_iterator([&collides, &func](
+				const WallsCollisionScene::t_idxvalue& val)
+			{
+				// skip remaining candidates after the first collision
+				if(!collides)
+					collides = func(val.second);
+			}));
+
+		return collides;
+	};
 	// ------------------------------------------------------------------------
 
 
@@ -642,44 +833,30 @@ bool InstrumentSpace::CheckCollision2D() const
 	const Axis& mono = GetInstrument().GetMonochromator();
 	const Axis& sample = GetInstrument().GetSample();
 	const Axis& ana = GetInstrument().GetAnalyser();
-	const auto& walls = GetWalls();
-
-	std::vector<std::tuple<t_vec, t_real>>
-		monoCircles, monoCirclesIntOut,
-		sampleCircles,
-		anaCircles;
-	std::vector<std::vector<t_vec>>
-		monoPolys, monoPolysIn, monoPolysIntOut,
-		samplePolys, samplePolysIn,
-		anaPolys, anaPolysOut;
-
-	get_circles(mono, monoCircles);
-	get_circles(mono, monoCirclesIntOut, false, true, true);
-	get_circles(sample, sampleCircles);
-	get_circles(ana, anaCircles);
-
-	get_polys(mono, monoPolys);
-	get_polys(mono, monoPolysIn, true, false, false);
-	get_polys(mono, monoPolysIntOut, false, true, true);
-	get_polys(sample, samplePolys);
-	get_polys(sample, samplePolysIn, true, false, false);
-	get_polys(ana, anaPolys);
-	get_polys(ana, anaPolysOut, false, false, true);
-
-
-	// convert to fixed 2d vectors for efficiency
-	auto monoCircles2d = convert_circles_2d(monoCircles);
-	auto monoCirclesIntOut2d = convert_circles_2d(monoCirclesIntOut);
-	auto sampleCircles2d = convert_circles_2d(sampleCircles);
-	auto anaCircles2d = convert_circles_2d(anaCircles);
-
-	auto monoPolys2d = convert_polys_2d(monoPolys);
-	auto monoPolysIn2d = convert_polys_2d(monoPolysIn);
-	auto monoPolysIntOut2d = convert_polys_2d(monoPolysIntOut);
-	auto samplePolys2d = convert_polys_2d(samplePolys);
-	auto samplePolysIn2d = convert_polys_2d(samplePolysIn);
-	auto anaPolys2d = convert_polys_2d(anaPolys);
-	auto anaPolysOut2d = convert_polys_2d(anaPolysOut);
+
+	// the instrument components are directly transformed
+	// into fixed-size 2d vectors for efficiency
+	std::vector<std::tuple<t_vec2, t_real>>
+		monoCircles2d, monoCirclesIntOut2d,
+		sampleCircles2d,
+		anaCircles2d;
+	std::vector<std::vector<t_vec2>>
+		monoPolys2d, monoPolysIn2d, monoPolysIntOut2d,
+		samplePolys2d, samplePolysIn2d,
+		anaPolys2d, anaPolysOut2d;
+
+	get_circles(mono, monoCircles2d);
+	get_circles(mono, monoCirclesIntOut2d, false, true, true);
+	get_circles(sample, sampleCircles2d);
+	get_circles(ana, anaCircles2d);
+
+	get_polys(mono, monoPolys2d);
+	get_polys(mono, monoPolysIn2d, true, false, false);
+	get_polys(mono, monoPolysIntOut2d, false, true, true);
+	get_polys(sample, samplePolys2d);
+	get_polys(sample, samplePolysIn2d, true, false, false);
+	get_polys(ana, anaPolys2d);
+	get_polys(ana, anaPolysOut2d, false, false, true);
 
 
 	// get bounding boxes
@@ -697,69 +874,76 @@ bool InstrumentSpace::CheckCollision2D() const
 	auto anaCircleBB = tl2::sphere_bounding_box<t_vec2, std::vector>(anaCircles2d, 2);
 
 
-	// check for collisions with the walls
-	for(const auto& wall : walls)
+	// check for collisions with the walls, which have been flattened
+	// into 2d primitives and sorted into index trees beforehand
+	// wall polygons overlapping with the instrument components
+	auto check_wall_poly = [&walls, &check_collision_poly_poly, &check_collision_circle_poly](
+		std::size_t wallidx,
+		const std::vector<std::vector<t_vec2>>& polys2d,
+		const std::vector<std::tuple<t_vec2, t_real>>& circles2d,
+		const std::tuple<t_vec2, t_vec2>& polysBB,
+		const std::tuple<t_vec2, t_vec2>& circlesBB) -> bool
 	{
-		// wall polygons
-		std::vector<t_vec> wallPoly;
-		get_comp_polys(wall, wallPoly);
+		std::span<const std::vector<t_vec2>> wallPolys2d{&walls.polys[wallidx], 1};
+		const auto& wallBB = walls.polys_bb[wallidx];
 
-		auto wallPoly2d = convert_poly_2d(wallPoly);
-		if(wallPoly2d && wallPoly2d->size())
-		{
-			std::vector<std::vector<t_vec2>> wallPolys2d;
-			wallPolys2d.push_back(*wallPoly2d);
-
-			auto wallBB = tl2::bounding_box<t_vec2, std::vector>(wallPolys2d, 2);
-
-			// check for collisions
-			// TODO: exclude checks for objects that are already colliding
-			//       in the instrument definition file
-
-			if(check_collision_poly_poly(monoPolysIntOut2d, wallPolys2d, monoIntOutBB, wallBB))
-				return true;
-			if(check_collision_poly_poly(samplePolys2d, wallPolys2d, sampleBB, wallBB))
-				return true;
-			if(check_collision_poly_poly(anaPolys2d, wallPolys2d, anaBB, wallBB))
-				return true;
-
-			if(check_collision_circle_poly(monoCirclesIntOut2d, wallPolys2d, monoCircleIntOutBB, wallBB))
-				return true;
-			if(check_collision_circle_poly(sampleCircles2d, wallPolys2d, sampleCircleBB, wallBB))
-				return true;
-			if(check_collision_circle_poly(anaCircles2d, wallPolys2d, anaCircleBB, wallBB))
-				return true;
-		}
+		// TODO: exclude checks for objects that are already colliding
+		//       in the instrument definition file
+		if(check_collision_poly_poly(polys2d, wallPolys2d, polysBB, wallBB))
+			return true;
+		if(check_collision_circle_poly(circles2d, wallPolys2d, circlesBB, wallBB))
+			return true;
 
+		return false;
+	};
 
-		// wall circles
-		std::tuple<t_vec, t_real> wallCircle;
-		get_comp_circles(wall, wallCircle);
+	// wall circles overlapping with the instrument components
+	auto check_wall_circle = [&walls, &check_collision_circle_circle, &check_collision_circle_poly](
+		std::size_t wallidx,
+		const std::vector<std::vector<t_vec2>>& polys2d,
+		const std::vector<std::tuple<t_vec2, t_real>>& circles2d,
+		const std::tuple<t_vec2, t_vec2>& polysBB) -> bool
+	{
+		std::span<const std::tuple<t_vec2, t_real>> wallCircles2d{&walls.circles[wallidx], 1};
+		const auto& wallCirclesBB = walls.circles_bb[wallidx];
 
-		auto wallCircle2d = convert_circle_2d(wallCircle);
-		if(wallCircle2d && std::get<0>(*wallCircle2d).size())
-		{
-			std::vector<std::tuple<t_vec2, t_real>> wallCircles2d;
-			wallCircles2d.push_back(*wallCircle2d);
-
-			auto wallCirclesBB = tl2::sphere_bounding_box<t_vec2, std::vector>(wallCircles2d, 2);
-
-			if(check_collision_circle_circle(monoCirclesIntOut2d, wallCircles2d))
-				return true;
-			if(check_collision_circle_circle(sampleCircles2d, wallCircles2d))
-				return true;
-			if(check_collision_circle_circle(anaCircles2d, wallCircles2d))
-				return true;
-
-			if(check_collision_circle_poly(wallCircles2d, monoPolys2d, wallCirclesBB, monoBB))
-				return true;
-			if(check_collision_circle_poly(wallCircles2d, samplePolys2d, wallCirclesBB, sampleBB))
-				return true;
-			if(check_collision_circle_poly(wallCircles2d, anaPolys2d, wallCirclesBB, anaBB))
-				return true;
-		}
-	}
+		if(check_collision_circle_circle(circles2d, wallCircles2d))
+			return true;
+		if(check_collision_circle_poly(wallCircles2d, polys2d, wallCirclesBB, polysBB))
+			return true;
+
+		return false;
+	};
 
+	// only query the walls near the respective instrument components
+	if(query_walls(walls.polys_tree, merge_bbs(monoIntOutBB, monoCircleIntOutBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_poly(wallidx,
+			monoPolysIntOut2d, monoCirclesIntOut2d, monoIntOutBB, monoCircleIntOutBB); }))
+		return true;
+	if(query_walls(walls.polys_tree, merge_bbs(sampleBB, sampleCircleBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_poly(wallidx,
+			samplePolys2d, sampleCircles2d, sampleBB, sampleCircleBB); }))
+		return true;
+	if(query_walls(walls.polys_tree, merge_bbs(anaBB, anaCircleBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_poly(wallidx,
+			anaPolys2d, anaCircles2d, anaBB, anaCircleBB); }))
+		return true;
+
+	if(query_walls(walls.circles_tree, merge_bbs(monoBB, monoCircleIntOutBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_circle(wallidx,
+			monoPolys2d, monoCirclesIntOut2d, monoBB); }))
+		return true;
+	if(query_walls(walls.circles_tree, merge_bbs(sampleBB, sampleCircleBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_circle(wallidx,
+			samplePolys2d, sampleCircles2d, sampleBB); }))
+		return true;
+	if(query_walls(walls.circles_tree, merge_bbs(anaBB, anaCircleBB),
+		[&](std::size_t wallidx) -> bool { return check_wall_circle(wallidx,
+			anaPolys2d, anaCircles2d, anaBB); }))
+		return true;
+
+	if(!check_self)
+		return false;
 
 	// check for instrument self-collisions
 	// circle-circle
@@ -833,6 +1017,7 @@ void InstrumentSpace::DragObject(bool drag_start, const std::string& obj,
 
 	if(wall_dragged)
 	{
+		WallsChanged();
 		EmitUpdate();
 		GetInstrument().EmitUpdate();	// needed to trigger collision detection
 	}
@@ -950,9 +1135,11 @@ std::tuple<bool, std::shared_ptr<Geometry>> InstrumentSpace::SetProperties(
 		}); iter != m_walls.end())
 	{
 		(*iter)->SetProperties(props);
+		WallsChanged();
 		return std::make_tuple(true, *iter);
 	}
 
 	// otherwise pass the data on to the instrument
+	InstrumentChanged();
 	return m_instr.SetProperties(obj, props);
 }
@@ -26,9 +26,15 @@
 #ifndef __INSTR_SPACE_H__
 #define __INSTR_SPACE_H__
 
+#include <vector>
+#include <tuple>
+#include <memory>
+
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/signals2/signal.hpp>
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
 
 #include "types.h"
 #include "Geometry.h"
@@ -36,6 +42,45 @@
 
 
 
+// ----------------------------------------------------------------------------
+// static wall geometry, flattened into 2d primitives for collision checks
+// ----------------------------------------------------------------------------
+struct WallsCollisionScene
+{
+	// spatial index over the bounding boxes of the wall primitives
+	using t_idxvertex = boost::geometry::model::point<
+		t_real, 2, boost::geometry::cs::cartesian>;
+	using t_idxbox = boost::geometry::model::box<t_idxvertex>;
+	using t_idxvalue = std::pair<t_idxbox, std::size_t>;
+	using t_idxtree = boost::geometry::index::rtree<
+		t_idxvalue, boost::geometry::index::rstar<8>>;
+
+	// wall polygons and their bounding boxes
+	std::vector<std::vector<t_vec2>> polys{};
+	std::vector<std::tuple<t_vec2, t_vec2>> polys_bb{};
+
+	// wall circles and their bounding boxes
+	std::vector<std::tuple<t_vec2, t_real>> circles{};
+	std::vector<std::tuple<t_vec2, t_vec2>> circles_bb{};
+
+	// index trees for the polygon and circle bounding boxes
+	t_idxtree polys_tree{};
+	t_idxtree circles_tree{};
+
+	// version of the walls this scene was compiled from
+	std::size_t version = 0;
+
+	bool IsEmpty() const { return polys.size() == 0 && circles.size() == 0; }
+	void BuildIndexTrees();
+
+	// get the primitives which are not part of the other scene
+	std::shared_ptr<WallsCollisionScene> GetDifference(
+		const WallsCollisionScene& other, t_real eps) const;
+};
+// ----------------------------------------------------------------------------
+
+
+
 // ----------------------------------------------------------------------------
 // instrument space
 // ----------------------------------------------------------------------------
@@ -69,6 +114,15 @@ public:
 
 	bool CheckAngularLimits() const;
 	bool CheckCollision2D() const;
+	bool CheckCollision2D(const WallsCollisionScene& walls, bool check_self = true) const;
+
+	// radius around the axis position that contains the 2d footprints of all axis components
+	static t_real GetAxisReach2D(const Axis& axis);
+
+	// precompiled wall geometry
+	std::size_t GetWallsVersion() const { return m_walls_version; }
+	std::size_t GetInstrumentVersion() const { return m_instr_version; }
+	std::shared_ptr<const WallsCollisionScene> GetWallsCollisionScene() const;
 
 	void DragObject(bool drag_start, const std::string& obj,
 		t_real x_start, t_real y_start, t_real x, t_real y);
@@ -122,6 +176,20 @@ private:
 	// which polygon intersection method should be used?
 	// 0: sweep, 1: half-plane test
 	int m_poly_intersection_method = 1;
+
+	// counter which is incremented whenever the walls change
+	std::size_t m_walls_version = 0;
+
+	// unique id which changes whenever the instrument is changed
+	std::size_t m_instr_version = 0;
+
+	// flattened wall geometry, compiled on demand and shared between copies
+	mutable std::shared_ptr<const WallsCollisionScene> m_walls_scene{};
+
+
+protected:
+	void WallsChanged();
+	void InstrumentChanged();
 };
 // ----------------------------------------------------------------------------
 
@@ -43,15 +43,11 @@
 // paths builder -- path calculation part
 // ----------------------------------------------------------------------------
 /**
- * get path length, taking into account the motor speeds
+ * get the (a4, a2) motor speeds,
+ * a2 refers to the analyser a6 in case kf is not fixed
  */
-t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
+t_vec2 PathsBuilder::GetMotorSpeeds() const
 {
-	// directly calculate length if motor speeds are not used
-	if(!m_use_motor_speeds)
-		return tl2::norm<t_vec2>(_vec);
-
-
 	// move analysator instead of monochromator?
 	bool kf_fixed = true;
 	if(m_tascalc)
@@ -70,99 +66,452 @@ t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
 	// sample 2theta angular speed
 	t_real a4_speed = instr.GetSample().GetAxisAngleOutSpeed();
 
+	return tl2::create<t_vec2>({a4_speed, a2_speed});
+}
+
+
+/**
+ * get path length, taking into account the motor speeds
+ */
+t_real PathsBuilder::GetPathLength(const t_vec2& _vec) const
+{
+	// directly calculate length if motor speeds are not used
+	if(!m_use_motor_speeds)
+		return tl2::norm<t_vec2>(_vec);
+
+	const t_vec2 speeds = GetMotorSpeeds();
+
 	t_vec2 vec = _vec;
-	vec[0] /= a4_speed;
-	vec[1] /= a2_speed;
+	vec[0] /= speeds[0];
+	vec[1] /= speeds[1];
 
 	return tl2::norm<t_vec2>(vec);
 }
 
 
 /**
- * find a path from an initial (a2, a4) to a final (a2, a4)
- * the monochromator a1/a2 variables can alternatively refer to the analyser a5/a6 in case kf is not fixed
+ * get the path length of a single pixel step in x (a4) and y (a2) direction,
+ * this is the metric of the configuration space
  */
-InstrumentPath PathsBuilder::FindPath(
-	t_real a2_i, t_real a4_i,
-	t_real a2_f, t_real a4_f,
-	PathStrategy pathstrategy)
+t_vec2 PathsBuilder::GetPixelMetric() const
 {
-	InstrumentPath path{};
-	path.ok = false;
+	t_vec2 metric = tl2::create<t_vec2>({
+		std::abs(m_sampleScatteringRange[1] - m_sampleScatteringRange[0]) / t_real(m_img.GetWidth()),
+		std::abs(m_monoScatteringRange[1] - m_monoScatteringRange[0]) / t_real(m_img.GetHeight()) });
 
-	// check if start or target point are within obstacles
+	if(m_use_motor_speeds && m_instrspace)
 	{
-		if(!m_instrspace)
-			return path;
+		const t_vec2 speeds = GetMotorSpeeds();
+		metric[0] /= std::abs(speeds[0]);
+		metric[1] /= std::abs(speeds[1]);
+	}
+
+	return metric;
+}
+
 
-		const t_real *sensesCCW = nullptr;
-		std::size_t mono_idx = 0;
-		bool kf_fixed = true;
-		if(m_tascalc)
+/**
+ * check if the instrument can be moved to an (a2, a4) position,
+ * i.e. if the position is within the angular limits and free of collisions
+ * @arg instrspace copy of the instrument space whose angles are changed
+ */
+bool PathsBuilder::IsInstrumentPositionAllowed(
+	InstrumentSpace& instrspace, t_real a2, t_real a4) const
+{
+	const t_real *sensesCCW = nullptr;
+	std::size_t mono_idx = 0;
+	bool kf_fixed = true;
+	if(m_tascalc)
+	{
+		sensesCCW = m_tascalc->GetScatteringSenses();
+
+		// move analysator instead of monochromator?
+		if(!std::get<1>(m_tascalc->GetKfix()))
 		{
-			sensesCCW = m_tascalc->GetScatteringSenses();
+			kf_fixed = false;
+			mono_idx = 2;
+		}
+	}
 
-			// move analysator instead of monochromator?
-			if(!std::get<1>(m_tascalc->GetKfix()))
+	Instrument& instr = instrspace.GetInstrument();
+
+	// set instrument angles to the position
+	if(sensesCCW)
+	{
+		a2 *= sensesCCW[mono_idx];
+		a4 *= sensesCCW[1];
+	}
+
+	if(kf_fixed)
+	{
+		instr.GetMonochromator().SetAxisAngleOut(a2);
+		instr.GetMonochromator().SetAxisAngleInternal(0.5 * a2);
+	}
+	else
+	{
+		instr.GetAnalyser().SetAxisAngleOut(a2);
+		instr.GetAnalyser().SetAxisAngleInternal(0.5 * a2);
+	}
+	instr.GetSample().SetAxisAngleOut(a4);
+
+	bool in_angular_limits = instrspace.CheckAngularLimits();
+	bool colliding = instrspace.CheckCollision2D();
+
+	return in_angular_limits && !colliding;
+}
+
+
+/**
+ * find the voronoi vertex to which a position is retracted
+ * @arg vec position in pixel coordinates
+ */
+std::optional<std::size_t> PathsBuilder::FindRetractionVertex(const t_vec2& vec) const
+{
+	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+
+	// no voronoi vertices available
+	if(voro_vertices.size() == 0)
+		return std::nullopt;
+
+	// calculation of closest voronoi vertices using the index tree
+	if(m_voro_results.GetIndexTreeSize())
+	{
+		// check closest voronoi vertices for a possible path from the position to a retraction point
+		std::vector<std::size_t> indices = m_voro_results.GetClosestVoronoiVertices(
+			vec, m_num_closest_voronoi_vertices, true);
+
+		std::vector<t_vec2> verts;
+		verts.reserve(indices.size());
+		for(std::size_t idx : indices)
+			verts.push_back(voro_vertices[idx]);
+
+		// first look for the voronoi vertex where the path keeps the minimum
+		// distance to the walls; second just use first non-colliding path
+		for(bool use_min_dist : {true, false})
+		{
+			if(auto found_idx = FindNonCollidingDirectPathPixel(
+				vec, verts, use_min_dist); found_idx)
 			{
-				kf_fixed = false;
-				mono_idx = 2;
+				return indices[*found_idx];
 			}
 		}
 
-		InstrumentSpace instrspace_cpy = *this->m_instrspace;
-		Instrument& instr = instrspace_cpy.GetInstrument();
+		//std::cerr << "Retraction voronoi vertex not found!" << std::endl;
+		return std::nullopt;
+	}
 
-		// set instrument angles to start point
-		t_real a2 = a2_i;
-		t_real a4 = a4_i;
-		if(sensesCCW)
+	// alternate calculation without index tree
+	t_real mindist = std::numeric_limits<t_real>::max();
+	std::size_t idx_closest = 0;
+
+	for(std::size_t idx_vert = 0; idx_vert < voro_vertices.size(); ++idx_vert)
+	{
+		const t_vec2& cur_vert = voro_vertices[idx_vert];
+		//std::cout << "cur_vert: " << cur_vert[0] << " " << cur_vert[1] << std::endl;
+
+		t_vec2 diff = vec - cur_vert;
+		t_real dist_sq = tl2::inner<t_vec2>(diff, diff);
+
+		if(dist_sq < mindist)
 		{
-			a2 *= sensesCCW[mono_idx];
-			a4 *= sensesCCW[1];
+			mindist = dist_sq;
+			idx_closest = idx_vert;
 		}
+	}
+
+	return idx_closest;
+}
+
+
+/**
+ * get the edge weight function of the voronoi graph for a path strategy
+ */
+std::function<std::optional<PathsBuilder::t_graph::t_weight>(std::size_t, std::size_t)>
+PathsBuilder::GetVoronoiEdgeWeightFunction(PathStrategy pathstrategy) const
+{
+	using t_weight = typename t_graph::t_weight;
+	const auto& voro_graph = m_voro_results.GetVoronoiGraph();
+
+	// callback function with which the graph's edge weights can be modified
+	return [this, &voro_graph, pathstrategy](
+		std::size_t idx1, std::size_t idx2) -> std::optional<t_weight>
+	{
+		// get original graph edge weight
+		auto _weight = voro_graph.GetWeight(idx1, idx2);
+		if(!_weight)
+			return std::nullopt;
+
+		// shortest path -> just use original edge weights
+		if(pathstrategy == PathStrategy::SHORTEST)
+			return _weight;
+
+
+		t_weight weight = *_weight;
+
+		// get the distances to the wall vertices that are closest to the current voronoi vertices
+		t_real dist1 = GetVoronoiVertexDistToWalls(idx1);
+		t_real dist2 = GetVoronoiVertexDistToWalls(idx2);
+		t_real min_dist = std::min(dist1, dist2);
+
+		// parabolic edges can come closer to the walls than their end points
+		if(auto iter = m_voro_edge_wall_dists.find(std::make_pair(idx1, idx2));
+			iter != m_voro_edge_wall_dists.end())
+			min_dist = std::min(min_dist, iter->second);
 
-		if(kf_fixed)
+		// vertices touching a wall would yield infinite or undefined weights
+		min_dist = std::max(min_dist, m_eps);
+
+		// modify edge weights using the minimum distance to the next wall
+		if(pathstrategy == PathStrategy::PENALISE_WALLS)
+			return weight / min_dist;
+
+		return weight;
+	};
+}
+
+
+/**
+ * get the voronoi vertex indices of a path from the predecessors of a graph search
+ */
+std::pair<bool, std::vector<std::size_t>> PathsBuilder::GetVoronoiPathFromPredecessors(
+	const std::vector<std::optional<std::size_t>>& predecessors,
+	std::size_t idx_initial, std::size_t idx_final)
+{
+	if(predecessors.size() <= std::max(idx_initial, idx_final))
+		return std::make_pair(false, std::vector<std::size_t>{});
+
+	std::vector<std::size_t> voro_indices;
+
+	// index of final voronoi vertex
+	std::size_t cur_vertidx = idx_final;
+	bool ok = false;
+
+	while(true)
+	{
+		voro_indices.push_back(cur_vertidx);
+
+		// found full path?
+		if(cur_vertidx == idx_initial)
 		{
-			instr.GetMonochromator().SetAxisAngleOut(a2);
-			instr.GetMonochromator().SetAxisAngleInternal(0.5 * a2);
+			ok = true;
+			break;
 		}
-		else
+
+		auto next_vertidx = predecessors[cur_vertidx];
+		if(!next_vertidx || voro_indices.size() > predecessors.size())
 		{
-			instr.GetAnalyser().SetAxisAngleOut(a2);
-			instr.GetAnalyser().SetAxisAngleInternal(0.5 * a2);
+			ok = false;
+			break;
 		}
-		instr.GetSample().SetAxisAngleOut(a4);
 
-		bool in_angular_limits = instrspace_cpy.CheckAngularLimits();
-		bool colliding = instrspace_cpy.CheckCollision2D();
-		if(!in_angular_limits || colliding)
-			return path;
+		cur_vertidx = *next_vertidx;
+	}
+
+	std::reverse(voro_indices.begin(), voro_indices.end());
+	return std::make_pair(ok, voro_indices);
+}
+
+
+/**
+ * find the shortest path between two voronoi vertices
+ */
+std::pair<bool, std::vector<std::size_t>> PathsBuilder::FindShortestVoronoiPath(
+	std::size_t idx_initial, std::size_t idx_final, PathStrategy pathstrategy) const
+{
+	using t_weight = typename t_graph::t_weight;
+
+	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+	const auto& voro_graph = m_voro_results.GetVoronoiGraph();
+
+	// are the graph vertex indices valid?
+	if(idx_initial >= voro_graph.GetNumVertices() || idx_final >= voro_graph.GetNumVertices())
+		return std::make_pair(false, std::vector<std::size_t>{});
+
+	auto weight_func = GetVoronoiEdgeWeightFunction(pathstrategy);
+
+	// lower bound of the weighted path length from a voronoi vertex to the final one,
+	// the edge weights are at least the euclidean distances between the vertices
+	auto heuristic_func = [this, &voro_vertices, idx_final, pathstrategy](std::size_t idx) -> t_weight
+	{
+		t_weight dist = tl2::norm<t_vec2>(voro_vertices[idx_final] - voro_vertices[idx]);
 
-		// set instrument angles to target point
-		a2 = a2_f;
-		a4 = a4_f;
-		if(sensesCCW)
+		// the penalised edge weights are divided by at most the maximum wall distance
+		if(pathstrategy == PathStrategy::PENALISE_WALLS)
 		{
-			a2 *= sensesCCW[mono_idx];
-			a4 *= sensesCCW[1];
+			if(m_voro_wall_dists.size() == voro_vertices.size())
+				dist /= m_max_voro_wall_dist;
+			else
+				dist /= m_max_wall_dist;
 		}
 
-		if(kf_fixed)
+		return dist;
+	};
+
+	const std::string& ident_initial = voro_graph.GetVertexIdent(idx_initial);
+	const std::string& ident_final = voro_graph.GetVertexIdent(idx_final);
+
+	// find shortest path given the above weight function
+	std::vector<std::optional<std::size_t>> predecessors;
+	switch(m_pathsearch)
+	{
+		case PathSearch::ASTAR:
+			predecessors = geo::astar(voro_graph, ident_initial, ident_final,
+				&heuristic_func, &weight_func);
+			break;
+
+		case PathSearch::BIDIRECTIONAL:
+			predecessors = geo::dijk_bidir(voro_graph, ident_initial, ident_final,
+				&weight_func);
+			break;
+
+		default:
+		case PathSearch::DIJKSTRA:
 		{
-			instr.GetMonochromator().SetAxisAngleOut(a2);
-			instr.GetMonochromator().SetAxisAngleInternal(0.5 * a2);
+	#if TASPATHS_SSSP_IMPL==1
+			predecessors = geo::dijk(voro_graph, ident_initial, &weight_func);
+	#elif TASPATHS_SSSP_IMPL==2
+			predecessors = geo::dijk_mod(voro_graph, ident_initial, &weight_func);
+	#elif TASPATHS_SSSP_IMPL==3
+			std::tie(std::ignore, predecessors) = geo::bellman(
+				voro_graph, ident_initial, &weight_func);
+	#else
+			#error No suitable value for TASPATHS_SSSP_IMPL has been set!
+	#endif
+			break;
 		}
-		else
+	}
+
+	return GetVoronoiPathFromPredecessors(predecessors, idx_initial, idx_final);
+}
+
+
+/**
+ * find the retraction points from the start and end point of a path towards the path mesh,
+ * the path's voronoi vertices are changed if a closer bisector is found
+ * @returns false if no valid retraction has been found
+ */
+bool PathsBuilder::RetractPathEnds(InstrumentPath& path, PathStrategy pathstrategy) const
+{
+	if(path.voronoi_indices.size() < 2)
+		return true;
+
+	// find closest start point
+	std::size_t vert_idx1_begin = path.voronoi_indices[0];
+	std::size_t vert_idx2_begin = path.voronoi_indices[1];
+
+	auto [min_param_begin, bisector_begin, bisector_type_begin, collides_begin] =
+		FindClosestBisector(vert_idx1_begin, vert_idx2_begin, path.vec_i);
+	if(collides_begin)
+		return false;
+
+	// another neighbour edge is closer
+	// vert_idx1_begin is still the same
+	if(std::get<1>(bisector_begin)==vert_idx1_begin && std::get<0>(bisector_begin)!=vert_idx2_begin)
+	{
+		path.voronoi_indices.insert(path.voronoi_indices.begin(), std::get<0>(bisector_begin));
+	}
+	// a completely different bisector has been found, use dijkstra again to find a path
+	else if(std::get<1>(bisector_begin)!=vert_idx1_begin && std::get<0>(bisector_begin)!=vert_idx2_begin)
+	{
+		if(auto[pathseg_ok, pathseg] = FindShortestVoronoiPath(
+			vert_idx2_begin, std::get<1>(bisector_begin), pathstrategy); pathseg_ok)
 		{
-			instr.GetAnalyser().SetAxisAngleOut(a2);
-			instr.GetAnalyser().SetAxisAngleInternal(0.5 * a2);
+			path.voronoi_indices.erase(path.voronoi_indices.begin(), path.voronoi_indices.begin()+2);
+			for(std::size_t pathseg_idx=0; pathseg_idx<pathseg.size(); ++pathseg_idx)
+				path.voronoi_indices.insert(path.voronoi_indices.begin(), pathseg[pathseg_idx]);
+			path.voronoi_indices.insert(path.voronoi_indices.begin(), std::get<0>(bisector_begin));
+
+			geo::remove_path_loops<std::size_t>(path.voronoi_indices);
+			if(path.voronoi_indices.size() < 2)
+				return false;
 		}
-		instr.GetSample().SetAxisAngleOut(a4);
+	}
+
+	path.param_i = min_param_begin;
+	path.is_linear_i = (bisector_type_begin == 1);
+
 
-		in_angular_limits = instrspace_cpy.CheckAngularLimits();
-		colliding = instrspace_cpy.CheckCollision2D();
-		if(!in_angular_limits || colliding)
+	// find closest end point
+	std::size_t vert_idx1_end = *path.voronoi_indices.rbegin();
+	std::size_t vert_idx2_end = *(path.voronoi_indices.rbegin()+1);
+
+	auto [min_param_end, bisector_end, bisector_type_end, collides_end] =
+		FindClosestBisector(vert_idx1_end, vert_idx2_end, path.vec_f);
+	if(collides_end)
+		return false;
+
+	// another neighbour edge is closer
+	// vert_idx1_end is still the same
+	if(std::get<1>(bisector_end)==vert_idx1_end && std::get<0>(bisector_end)!=vert_idx2_end)
+	{
+		path.voronoi_indices.push_back(std::get<0>(bisector_end));
+	}
+	// a completely different bisector has been found, use dijkstra again to find a path
+	else if(std::get<1>(bisector_end)!=vert_idx1_end && std::get<0>(bisector_end)!=vert_idx2_end)
+	{
+		if(auto[pathseg_ok, pathseg] = FindShortestVoronoiPath(
+			vert_idx2_end, std::get<1>(bisector_end), pathstrategy); pathseg_ok)
+		{
+			path.voronoi_indices.erase(path.voronoi_indices.end()-2, path.voronoi_indices.end());
+			for(std::size_t pathseg_idx=0; pathseg_idx<pathseg.size(); ++pathseg_idx)
+				path.voronoi_indices.push_back(pathseg[pathseg_idx]);
+			path.voronoi_indices.push_back(std::get<0>(bisector_end));
+
+			geo::remove_path_loops<std::size_t>(path.voronoi_indices);
+			if(path.voronoi_indices.size() < 2)
+				return false;
+		}
+	}
+
+	path.param_f = 1. - min_param_end;
+	path.is_linear_f = (bisector_type_end == 1);
+
+	return true;
+}
+
+
+/**
+ * test if a direct path from the initial to the final position of a path is possible
+ */
+bool PathsBuilder::IsDirectPathPossible(const InstrumentPath& path) const
+{
+	if(!m_directpath)
+		return false;
+
+	// is distance between start and target point within search radius
+	t_real dist_i_f = GetPathLength(
+		PixelToAngle(path.vec_f, false, false) -
+		PixelToAngle(path.vec_i, false, false));
+
+	if(dist_i_f > m_directpath_search_radius)
+		return false;
+
+	return !DoesDirectPathCollidePixel(path.vec_i, path.vec_f, true);
+}
+
+
+/**
+ * find a path from an initial (a2, a4) to a final (a2, a4)
+ * the monochromator a1/a2 variables can alternatively refer to the analyser a5/a6 in case kf is not fixed
+ */
+InstrumentPath PathsBuilder::FindPath(
+	t_real a2_i, t_real a4_i,
+	t_real a2_f, t_real a4_f,
+	PathStrategy pathstrategy) const
+{
+	InstrumentPath path{};
+	path.ok = false;
+
+	// check if start or target point are within obstacles
+	{
+		if(!m_instrspace)
+			return path;
+
+		InstrumentSpace instrspace_cpy = *this->m_instrspace;
+
+		if(!IsInstrumentPositionAllowed(instrspace_cpy, a2_i, a4_i))
+			return path;
+		if(!IsInstrumentPositionAllowed(instrspace_cpy, a2_f, a4_f))
 			return path;
 	}
 
@@ -190,360 +539,354 @@ InstrumentPath PathsBuilder::FindPath(
 
 
 	// test if a direct path is possible
-	if(m_directpath)
+	if(IsDirectPathPossible(path))
 	{
-		// is distance between start and target point within search radius
-		t_real dist_i_f = GetPathLength(
-			PixelToAngle(path.vec_f, false, false) -
-			PixelToAngle(path.vec_i, false, false));
-
-		if(dist_i_f <= m_directpath_search_radius)
-		{
-			bool collides = DoesDirectPathCollidePixel(
-				path.vec_i, path.vec_f, true);
-
-			// direct-path shortcut found
-			if(!collides)
-			{
-				path.ok = true;
-				path.is_direct = true;
-				return path;
-			}
-		}
+		// direct-path shortcut found
+		path.ok = true;
+		path.is_direct = true;
+		return path;
 	}
 
 
 	// find closest voronoi vertices
-	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+	std::optional<std::size_t> idx_i = FindRetractionVertex(path.vec_i);
+	if(!idx_i)
+		return path;
 
-	// no voronoi vertices available
-	if(voro_vertices.size() == 0)
+	std::optional<std::size_t> idx_f = FindRetractionVertex(path.vec_f);
+	if(!idx_f)
 		return path;
 
+#ifdef DEBUG
+	std::cout << "Nearest voronoi vertices: " << *idx_i << ", " << *idx_f << "." << std::endl;
+#endif
 
-	std::vector<std::size_t> indices_i{};
-	std::vector<std::size_t> indices_f{};
-	std::size_t idx_i = 0;
-	std::size_t idx_f = 0;
 
-	// calculation of closest voronoi vertices using the index tree
-	if(m_voro_results.GetIndexTreeSize())
+	// find shortest path from initial to final voronoi vertex
+	std::tie(path.ok, path.voronoi_indices) = FindShortestVoronoiPath(*idx_i, *idx_f, pathstrategy);
+
+
+#ifdef DEBUG
+	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+
+	std::cout << "Path ok: " << std::boolalpha << path.ok << std::endl;
+	for(std::size_t idx=0; idx<path.voronoi_indices.size(); ++idx)
 	{
-		// check closest voronoi vertices for a possible path from the initial position to a retraction point
-		bool found_i = false;
-		indices_i = m_voro_results.GetClosestVoronoiVertices(
-			path.vec_i, m_num_closest_voronoi_vertices, true);
+		std::size_t voro_idx = path.voronoi_indices[idx];
+		const t_vec2& voro_vertex = voro_vertices[voro_idx];
+		const t_vec2 voro_angle = PixelToAngle(voro_vertex[0], voro_vertex[1], true);
 
-		// first look for the voronoi vertex where the path keeps the minimum
-		// distance to the walls; second just use first non-colliding path
-		for(bool use_min_dist : {true, false})
-		{
-			for(std::size_t _idx_i : indices_i)
-			{
-				bool collides = DoesDirectPathCollidePixel(
-					path.vec_i, voro_vertices[_idx_i], use_min_dist);
+		std::cout << "\tvertex index " << voro_idx << ": pixel ("
+			<< voro_vertex[0] << ", " << voro_vertex[1] << "), angle ("
+			<< voro_angle[0] << ", " << voro_angle[1] << ")"
+			<< std::endl;
+	}
+#endif
 
-				if(!collides)
-				{
-					idx_i = _idx_i;
-					found_i = true;
-					break;
-				}
-			}
+	if(!path.ok)
+		return path;
 
-			if(found_i)
-				break;
-		}
+	// find the retraction points from the start/end point towards the path mesh
+	path.ok = RetractPathEnds(path, pathstrategy);
+	return path;
+}
 
-		if(!found_i)
-		{
-			//std::cerr << "Initial voronoi vertex not found!" << std::endl;
-			path.ok = false;
-			return path;
-		}
 
+/**
+ * calculate the shortest-path tree on the path mesh from an initial (a2, a4) position,
+ * the paths to any number of final positions can then be found using the tree
+ */
+InstrumentPathTree PathsBuilder::FindPathTree(
+	t_real a2_i, t_real a4_i, PathStrategy pathstrategy) const
+{
+	InstrumentPathTree tree{};
+	tree.ok = false;
+	tree.a2_i = a2_i;
+	tree.a4_i = a4_i;
+	tree.pathstrategy = pathstrategy;
 
-		// check closest voronoi vertices for a possible path from the target position to a retraction point
-		bool found_f = false;
-		indices_f = m_voro_results.GetClosestVoronoiVertices(
-			path.vec_f, m_num_closest_voronoi_vertices, true);
+	// check if the start point is within obstacles
+	if(!m_instrspace)
+		return tree;
 
-		for(bool use_min_dist : {true, false})
-		{
-			for(std::size_t _idx_f : indices_f)
-			{
-				bool collides = DoesDirectPathCollidePixel(
-					path.vec_f, voro_vertices[_idx_f], use_min_dist);
+	InstrumentSpace instrspace_cpy = *this->m_instrspace;
+	if(!IsInstrumentPositionAllowed(instrspace_cpy, a2_i, a4_i))
+		return tree;
 
-				if(!collides)
-				{
-					idx_f = _idx_f;
-					found_f = true;
-					break;
-				}
-			}
+	tree.vec_i = AngleToPixel(a4_i, a2_i, false);
+	tree.start_ok = true;
 
-			if(found_f)
-				break;
-		}
+	// find the voronoi vertex to start from
+	std::optional<std::size_t> idx_i = FindRetractionVertex(tree.vec_i);
+	if(!idx_i)
+		return tree;
+	tree.idx_i = *idx_i;
 
-		if(!found_f)
-		{
-			//std::cerr << "Final voronoi vertex not found!" << std::endl;
-			path.ok = false;
-			return path;
-		}
-	}
+	// calculate the shortest paths to all voronoi vertices
+	const auto& voro_graph = m_voro_results.GetVoronoiGraph();
+	if(tree.idx_i >= voro_graph.GetNumVertices())
+		return tree;
 
-	// alternate calculation without index tree
-	else
+	auto weight_func = GetVoronoiEdgeWeightFunction(pathstrategy);
+	tree.predecessors = geo::dijk(voro_graph,
+		voro_graph.GetVertexIdent(tree.idx_i), &weight_func, &tree.costs);
+
+	tree.ok = (tree.predecessors.size() == voro_graph.GetNumVertices());
+	return tree;
+}
+
+
+/**
+ * find a path from the initial position of a shortest-path tree to a final (a2, a4)
+ */
+InstrumentPath PathsBuilder::FindPath(const InstrumentPathTree& tree,
+	t_real a2_f, t_real a4_f) const
+{
+	InstrumentPath path{};
+	path.ok = false;
+
+	// the tree's start position is also needed for direct paths
+	if(!tree.start_ok || !m_instrspace)
+		return path;
+
+	// check if the target point is within obstacles
+	InstrumentSpace instrspace_cpy = *this->m_instrspace;
+	if(!IsInstrumentPositionAllowed(instrspace_cpy, a2_f, a4_f))
+		return path;
+
+	// vertices in configuration space
+	path.vec_i = tree.vec_i;
+	path.vec_f = AngleToPixel(a4_f, a2_f, false);
+
+	// test if a direct path is possible
+	if(IsDirectPathPossible(path))
 	{
-		t_real mindist_i = std::numeric_limits<t_real>::max();
-		t_real mindist_f = std::numeric_limits<t_real>::max();
+		path.ok = true;
+		path.is_direct = true;
+		return path;
+	}
 
-		for(std::size_t idx_vert = 0; idx_vert < voro_vertices.size(); ++idx_vert)
-		{
-			const t_vec2& cur_vert = voro_vertices[idx_vert];
-			//std::cout << "cur_vert: " << cur_vert[0] << " " << cur_vert[1] << std::endl;
+	// the tree itself is only needed for paths along the path mesh
+	if(!tree.ok)
+		return path;
+
+	// find the voronoi vertex of the target point and look up the path in the tree
+	std::optional<std::size_t> idx_f = FindRetractionVertex(path.vec_f);
+	if(!idx_f)
+		return path;
 
-			t_vec2 diff_i = path.vec_i - cur_vert;
-			t_vec2 diff_f = path.vec_f - cur_vert;
+	std::tie(path.ok, path.voronoi_indices) =
+		GetVoronoiPathFromPredecessors(tree.predecessors, tree.idx_i, *idx_f);
+	if(!path.ok)
+		return path;
 
-			t_real dist_i_sq = tl2::inner<t_vec2>(diff_i, diff_i);
-			t_real dist_f_sq = tl2::inner<t_vec2>(diff_f, diff_f);
+	// find the retraction points from the start/end point towards the path mesh
+	path.ok = RetractPathEnds(path, tree.pathstrategy);
+	return path;
+}
 
-			if(dist_i_sq < mindist_i)
-			{
-				mindist_i = dist_i_sq;
-				idx_i = idx_vert;
-			}
 
-			if(dist_f_sq < mindist_f)
-			{
-				mindist_f = dist_f_sq;
-				idx_f = idx_vert;
-			}
-		}
+/**
+ * get the shortest-path tree from an initial (a2, a4) position,
+ * the tree is cached and only calculated again if the position,
+ * the strategy or the path mesh have changed
+ */
+std::shared_ptr<const InstrumentPathTree> PathsBuilder::GetPathTree(
+	t_real a2_i, t_real a4_i, PathStrategy pathstrategy) const
+{
+	std::lock_guard<std::mutex> lock{m_pathtree_cache.mtx};
+
+	// the start position has to match exactly, since the paths found with
+	// the tree start at its initial vertex and not at the requested one
+	const std::shared_ptr<const InstrumentPathTree>& cached = m_pathtree_cache.tree;
+	if(cached && cached->pathstrategy == pathstrategy &&
+		cached->a2_i == a2_i && cached->a4_i == a4_i)
+	{
+		return cached;
 	}
 
-#ifdef DEBUG
-	std::cout << "Nearest voronoi vertices: " << idx_i << ", " << idx_f << "." << std::endl;
-#endif
+	m_pathtree_cache.tree = std::make_shared<InstrumentPathTree>(
+		FindPathTree(a2_i, a4_i, pathstrategy));
+	return m_pathtree_cache.tree;
+}
+
+
+/**
+ * remove the cached shortest-path tree
+ */
+void PathsBuilder::ClearPathTreeCache() const
+{
+	std::lock_guard<std::mutex> lock{m_pathtree_cache.mtx};
+	m_pathtree_cache.tree.reset();
+}
+
+
+/**
+ * get individual vertices on an instrument path
+ * (in angular coordinates)
+ */
+std::vector<t_vec2> PathsBuilder::GetPathVertices(
+	const InstrumentPath& path, bool subdivide_lines, bool deg) const
+{
+	std::vector<t_vec2> path_vertices = GetPathCornerVertices(path, deg);
+
+	// interpolate points on path line segments
+	if(subdivide_lines)
+	{
+		// direct paths are only subdivided, the other paths also skip close vertices
+		t_pathvertices subdivided_vertices(std::move(path_vertices), m_subdiv_len, !path.is_direct);
+		path_vertices = std::vector<t_vec2>(subdivided_vertices.begin(), subdivided_vertices.end());
+	}
 
+	// final verification
+	if(m_verifypath && !VerifyPath(path_vertices, deg).ok)
+		return {};
 
-	// find the shortest path between the voronoi vertices
-	const auto& voro_graph = m_voro_results.GetVoronoiGraph();
+	return path_vertices;
+}
 
-	// are the graph vertex indices valid?
-	if(idx_i >= voro_graph.GetNumVertices() || idx_f >= voro_graph.GetNumVertices())
-		return path;
 
-	using t_weight = typename t_graph::t_weight;
+/**
+ * get the vertices on an instrument path lazily (in angular coordinates),
+ * the line segments are subdivided on demand while iterating the range
+ * @arg spacing maximum distance between the vertices, 0 for the subdivision length
+ */
+PathsBuilder::t_pathvertices PathsBuilder::GetPathVertexRange(
+	const InstrumentPath& path, t_real spacing, bool deg) const
+{
+	if(spacing <= 0.)
+		spacing = m_subdiv_len;
 
-	// callback function with which the graph's edge weights can be modified
-	auto weight_func = [this, &voro_graph, &voro_vertices, pathstrategy](
-		std::size_t idx1, std::size_t idx2) -> std::optional<t_weight>
-	{
-		// get original graph edge weight
-		auto _weight = voro_graph.GetWeight(idx1, idx2);
-		if(!_weight)
-			return std::nullopt;
+	// direct paths are only subdivided, the other paths also skip close vertices
+	t_pathvertices path_vertices(GetPathCornerVertices(path, deg), spacing, !path.is_direct);
 
-		// shortest path -> just use original edge weights
-		if(pathstrategy == PathStrategy::SHORTEST)
-			return _weight;
+	// final verification, without materialising the subdivided vertices
+	if(m_verifypath && !VerifyPathVertices(path_vertices.begin(), path_vertices.end(), deg).ok)
+		return t_pathvertices{};
 
+	return path_vertices;
+}
 
-		t_weight weight = *_weight;
 
-		// get voronoi vertices of the current edge
-		const t_vec2& vertex1 = voro_vertices[idx1];
-		const t_vec2& vertex2 = voro_vertices[idx2];
+/**
+ * verify that the path segments don't collide with the walls and optionally
+ * re-check the full instrument geometry at a coarse angular step;
+ * the segments are checked in parallel chunks, and a chunk stops as soon
+ * as a collision has been found in a preceding segment
+ * @arg path path vertices in angular coordinates
+ */
+PathVerification PathsBuilder::VerifyPath(const std::vector<t_vec2>& path, bool deg) const
+{
+	// number of path segments per chunk
+	constexpr const std::size_t chunk_size = 64;
 
-		// get the distances to the wall vertices that are closest to the current voronoi vertices
-		t_real dist1 = GetDistToNearestWall(vertex1);
-		t_real dist2 = GetDistToNearestWall(vertex2);
-		t_real min_dist = std::min(dist1, dist2);
+	const std::size_t num_segments = path.size() > 1 ? path.size() - 1 : 0;
+	std::shared_ptr<ThreadPool> pool = m_threadpool;
 
-		// modify edge weights using the minimum distance to the next wall
-		if(pathstrategy == PathStrategy::PENALISE_WALLS)
-			return weight / min_dist;
+	// check short paths sequentially, and also the ones verified from within a worker thread
+	if(num_segments <= chunk_size || !pool || pool->IsWorkerThread() || pool->GetNumThreads() <= 1)
+		return VerifyPathVertices(path.begin(), path.end(), deg);
 
-		return weight;
-	};
+	// per-worker instrument copies for the checks against the full geometry
+	std::optional<WorkerContexts<InstrumentSpace>> instrspaces;
+	if(m_verifypath_geo_step > 0. && m_instrspace)
+		instrspaces.emplace(*m_instrspace, *pool);
 
+	// index of the first colliding segment found so far
+	std::atomic<std::size_t> first_collision{num_segments};
 
-	// execute dijkstra's algorithm
-	auto find_shortest_path = [&weight_func, &voro_graph](
-		std::size_t idx_initial, std::size_t idx_final)
-			-> std::pair<bool, std::vector<std::size_t>>
+	auto task = [this, &path, &instrspaces, &first_collision, deg](
+		std::size_t begin, std::size_t end, std::size_t worker)
 	{
-		const std::string& ident_initial = voro_graph.GetVertexIdent(idx_initial);
-
-		// find shortest path given the above weight function
-	#if TASPATHS_SSSP_IMPL==1
-		auto predecessors = geo::dijk(voro_graph, ident_initial, &weight_func);
-	#elif TASPATHS_SSSP_IMPL==2
-		auto predecessors = geo::dijk_mod(voro_graph, ident_initial, &weight_func);
-	#elif TASPATHS_SSSP_IMPL==3
-		auto [distvecs, predecessors] = geo::bellman(
-			voro_graph, ident_initial, &weight_func);
-	#else
-		#error No suitable value for TASPATHS_SSSP_IMPL has been set!
-		return std::make_pair(false, {});
-	#endif
+		InstrumentSpace *instrspace = instrspaces ? &instrspaces->Get(worker) : nullptr;
 
-		std::vector<std::size_t> voro_indices;
-		voro_indices.reserve(predecessors.size());
-
-		// index of final voronoi vertex
-		std::size_t cur_vertidx = idx_final;
-		bool ok = false;
-
-		while(true)
+		for(std::size_t seg_idx=begin; seg_idx<end; ++seg_idx)
 		{
-			voro_indices.push_back(cur_vertidx);
-
-			// found full path?
-			if(cur_vertidx == idx_initial)
-			{
-				ok = true;
+			// a preceding segment already collides
+			if(seg_idx >= first_collision.load(std::memory_order_relaxed))
 				break;
-			}
 
-			auto next_vertidx = predecessors[cur_vertidx];
-			if(!next_vertidx)
-			{
-				ok = false;
-				break;
-			}
+			if(VerifyPathSegment(path[seg_idx], path[seg_idx + 1], instrspace, deg).ok)
+				continue;
 
-			cur_vertidx = *next_vertidx;
+			// keep the smallest colliding segment index
+			std::size_t prev_collision = first_collision.load();
+			while(seg_idx < prev_collision &&
+				!first_collision.compare_exchange_weak(prev_collision, seg_idx))
+			{}
+			break;
 		}
-
-		std::reverse(voro_indices.begin(), voro_indices.end());
-		return std::make_pair(ok, voro_indices);
 	};
 
+	pool->ParallelFor(num_segments, chunk_size, task, nullptr,
+		instrspaces ? instrspaces->GetPrepareFunc() : nullptr);
 
-	// find shortest path from initial to final voronoi vertex
-	std::tie(path.ok, path.voronoi_indices) = find_shortest_path(idx_i, idx_f);
-
+	const std::size_t seg_idx = first_collision.load();
+	if(seg_idx >= num_segments)
+		return PathVerification{};
 
-#ifdef DEBUG
-	std::cout << "Path ok: " << std::boolalpha << path.ok << std::endl;
-	for(std::size_t idx=0; idx<path.voronoi_indices.size(); ++idx)
-	{
-		std::size_t voro_idx = path.voronoi_indices[idx];
-		const t_vec2& voro_vertex = voro_vertices[voro_idx];
-		const t_vec2 voro_angle = PixelToAngle(voro_vertex[0], voro_vertex[1], true);
+	// check the colliding segment again to report the kind of collision
+	PathVerification result = VerifyPathVertices(
+		path.begin() + seg_idx, path.begin() + seg_idx + 2, deg);
+	result.ok = false;
+	result.segment = seg_idx;
+	return result;
+}
 
-		std::cout << "\tvertex index " << voro_idx << ": pixel ("
-			<< voro_vertex[0] << ", " << voro_vertex[1] << "), angle ("
-			<< voro_angle[0] << ", " << voro_angle[1] << ")"
-			<< std::endl;
-	}
-#endif
 
-	if(!path.ok)
-		return path;
+/**
+ * check a path segment for collisions with the walls, and, if a geometry step is set,
+ * also the instrument positions along the segment against the full geometry
+ * @arg instrspace instrument copy for the geometry checks, nullptr to skip them
+ */
+PathVerification PathsBuilder::VerifyPathSegment(const t_vec2& vert1, const t_vec2& vert2,
+	InstrumentSpace* instrspace, bool deg) const
+{
+	PathVerification result{};
 
+	// check the configuration space pixels crossed by the segment
+	bool clear = tl2::equals<t_vec2>(vert1, vert2, m_eps)
+		? !DoesPositionCollide(vert1, deg)
+		: IsPathSegmentClear(vert1, vert2, 0., deg);
 
-	// find the retraction points from the start/end point towards the path mesh
-	if(path.voronoi_indices.size() >= 2)
+	if(!clear)
 	{
-		// find closest start point
-		std::size_t vert_idx1_begin = path.voronoi_indices[0];
-		std::size_t vert_idx2_begin = path.voronoi_indices[1];
-
-		auto [min_param_begin, bisector_begin, bisector_type_begin, collides_begin] =
-			FindClosestBisector(vert_idx1_begin, vert_idx2_begin, path.vec_i);
-		if(collides_begin)
-		{
-			path.ok = false;
-			return path;
-		}
-
-		// another neighbour edge is closer
-		// vert_idx1_begin is still the same
-		if(std::get<1>(bisector_begin)==vert_idx1_begin && std::get<0>(bisector_begin)!=vert_idx2_begin)
-		{
-			path.voronoi_indices.insert(path.voronoi_indices.begin(), std::get<0>(bisector_begin));
-		}
-		// a completely different bisector has been found, use dijkstra again to find a path
-		else if(std::get<1>(bisector_begin)!=vert_idx1_begin && std::get<0>(bisector_begin)!=vert_idx2_begin)
-		{
-			if(auto[pathseg_ok, pathseg] = find_shortest_path(vert_idx2_begin, std::get<1>(bisector_begin)); pathseg_ok)
-			{
-				path.voronoi_indices.erase(path.voronoi_indices.begin(), path.voronoi_indices.begin()+2);
-				for(std::size_t pathseg_idx=0; pathseg_idx<pathseg.size(); ++pathseg_idx)
-					path.voronoi_indices.insert(path.voronoi_indices.begin(), pathseg[pathseg_idx]);
-				path.voronoi_indices.insert(path.voronoi_indices.begin(), std::get<0>(bisector_begin));
-
-				geo::remove_path_loops<std::size_t>(path.voronoi_indices);
-				if(path.voronoi_indices.size() < 2)
-				{
-					path.ok = false;
-					return path;
-				}
-			}
-		}
-
-		path.param_i = min_param_begin;
-		path.is_linear_i = (bisector_type_begin == 1);
+		result.ok = false;
+		return result;
+	}
 
+	if(!instrspace || m_verifypath_geo_step <= 0.)
+		return result;
 
-		// find closest end point
-		std::size_t vert_idx1_end = *path.voronoi_indices.rbegin();
-		std::size_t vert_idx2_end = *(path.voronoi_indices.rbegin()+1);
+	// check the instrument geometry at a coarse step along the segment
+	const t_real to_rad = deg ? tl2::pi<t_real> / t_real(180) : t_real(1);
+	const t_vec2 pos1 = vert1 * to_rad;
+	const t_vec2 dir = (vert2 - vert1) * to_rad;
+	const std::size_t num_steps = std::max<std::size_t>(1,
+		static_cast<std::size_t>(std::ceil(tl2::norm<t_vec2>(dir) / m_verifypath_geo_step)));
 
-		auto [min_param_end, bisector_end, bisector_type_end, collides_end] =
-			FindClosestBisector(vert_idx1_end, vert_idx2_end, path.vec_f);
-		if(collides_end)
-		{
-			path.ok = false;
-			return path;
-		}
+	for(std::size_t step=0; step<=num_steps; ++step)
+	{
+		const t_vec2 pos = pos1 + dir * (t_real(step) / t_real(num_steps));
 
-		// another neighbour edge is closer
-		// vert_idx1_end is still the same
-		if(std::get<1>(bisector_end)==vert_idx1_end && std::get<0>(bisector_end)!=vert_idx2_end)
-		{
-			path.voronoi_indices.push_back(std::get<0>(bisector_end));
-		}
-		// a completely different bisector has been found, use dijkstra again to find a path
-		else if(std::get<1>(bisector_end)!=vert_idx1_end && std::get<0>(bisector_end)!=vert_idx2_end)
+		if(!IsInstrumentPositionAllowed(*instrspace, pos[1], pos[0]))
 		{
-			if(auto[pathseg_ok, pathseg] = find_shortest_path(vert_idx2_end, std::get<1>(bisector_end)); pathseg_ok)
-			{
-				path.voronoi_indices.erase(path.voronoi_indices.end()-2, path.voronoi_indices.end());
-				for(std::size_t pathseg_idx=0; pathseg_idx<pathseg.size(); ++pathseg_idx)
-					path.voronoi_indices.push_back(pathseg[pathseg_idx]);
-				path.voronoi_indices.push_back(std::get<0>(bisector_end));
-
-				geo::remove_path_loops<std::size_t>(path.voronoi_indices);
-				if(path.voronoi_indices.size() < 2)
-				{
-					path.ok = false;
-					return path;
-				}
-			}
+			result.ok = false;
+			result.geometry_collision = true;
+			break;
 		}
-
-		path.param_f = 1. - min_param_end;
-		path.is_linear_f = (bisector_type_end == 1);
 	}
 
-	return path;
+	return result;
 }
 
 
 /**
- * get individual vertices on an instrument path
+ * get the vertices at the corners of an instrument path
  * (in angular coordinates)
  */
-std::vector<t_vec2> PathsBuilder::GetPathVertices(
-	const InstrumentPath& path, bool subdivide_lines, bool deg) const
+std::vector<t_vec2> PathsBuilder::GetPathCornerVertices(
+	const InstrumentPath& path, bool deg) const
 {
 	// path vertices in angular coordinates (deg or rad)
 	std::vector<t_vec2> path_vertices;
@@ -557,13 +900,6 @@ std::vector<t_vec2> PathsBuilder::GetPathVertices(
 		path_vertices.push_back(PixelToAngle(path.vec_i, deg));
 		path_vertices.push_back(PixelToAngle(path.vec_f, deg));
 
-		// interpolate points
-		if(subdivide_lines)
-		{
-			path_vertices = geo::subdivide_lines<t_vec2>(
-				path_vertices, m_subdiv_len);
-		}
-
 		return path_vertices;
 	}
 
@@ -750,39 +1086,6 @@ std::vector<t_vec2> PathsBuilder::GetPathVertices(
 		RemovePathLoops(path_vertices, deg, true);
 	}
 
-
-	// interpolate points on path line segments
-	if(subdivide_lines)
-	{
-		path_vertices = geo::subdivide_lines<t_vec2>(path_vertices, m_subdiv_len);
-		path_vertices = geo::remove_close_vertices<t_vec2>(path_vertices, m_subdiv_len);
-	}
-
-
-	// final verification (this only works with path subdivision also active)
-	if(m_verifypath)
-	{
-		// check if we get closer to the walls than the minimum allowed distance
-		/*std::vector<t_real> min_dists = GetDistancesToNearestWall(path_vertices, deg);
-		if(auto min_elem = std::min_element(min_dists.begin(), min_dists.end()); min_elem != min_dists.end())
-		{
-			// ignore too close distances if the start or target point are already too close to a wall
-			// (because in this case we want to move away from the walls)
-			std::size_t min_idx = min_elem - min_dists.begin();
-
-			if(min_idx > 0 && min_idx < min_dists.size()-1 &&
-				*min_elem < m_min_angular_dist_to_walls)
-				return {};
-		}*/
-
-		// check if we're colliding with the walls
-		for(const t_vec2& pos : path_vertices)
-		{
-			if(DoesPositionCollide(pos, deg))
-				return {};
-		}
-	}
-
 	return path_vertices;
 }
 
@@ -817,18 +1120,171 @@ std::vector<t_real> PathsBuilder::GetDistancesToNearestWall(
 std::vector<std::pair<t_real, t_real>> PathsBuilder::GetPathVerticesAsPairs(
 	const InstrumentPath& path, bool subdivide_lines, bool deg) const
 {
-	std::vector<t_vec2> vertices = GetPathVertices(path, subdivide_lines, deg);
-
 	std::vector<std::pair<t_real, t_real>> pairs;
-	pairs.reserve(vertices.size());
 
-	for(const t_vec2& vec : vertices)
-		pairs.emplace_back(std::make_pair(vec[0], vec[1]));
+	if(!subdivide_lines)
+	{
+		std::vector<t_vec2> vertices = GetPathVertices(path, false, deg);
+		pairs.reserve(vertices.size());
+
+		for(const t_vec2& vec : vertices)
+			pairs.emplace_back(std::make_pair(vec[0], vec[1]));
+	}
+	else
+	{
+		// copy the subdivided vertices directly into the pairs
+		for(const t_vec2& vec : GetPathVertexRange(path, m_subdiv_len, deg))
+			pairs.emplace_back(std::make_pair(vec[0], vec[1]));
+	}
 
 	return pairs;
 }
 
 
+/**
+ * get the angular length of a path and the time the motors need to travel it,
+ * both motors move simultaneously, so the slower one determines the time of a segment
+ * @returns [length, time], the length is given in the units of the path vertices
+ */
+std::pair<t_real, t_real> PathsBuilder::GetPathLengthAndTravelTime(
+	const std::vector<t_vec2>& path, bool deg) const
+{
+	t_real length = 0;
+	t_real time = 0;
+
+	const t_vec2 speeds = m_instrspace
+		? GetMotorSpeeds()
+		: tl2::create<t_vec2>({0, 0});
+
+	for(std::size_t idx=1; idx<path.size(); ++idx)
+	{
+		t_vec2 delta = path[idx] - path[idx - 1];
+		length += tl2::norm<t_vec2>(delta);
+
+		// the motor speeds refer to angles in radians
+		if(deg)
+		{
+			delta[0] *= tl2::pi<t_real> / t_real(180);
+			delta[1] *= tl2::pi<t_real> / t_real(180);
+		}
+
+		t_real time_seg = 0;
+		for(std::size_t axis=0; axis<2; ++axis)
+		{
+			if(!tl2::equals_0<t_real>(speeds[axis], m_eps))
+				time_seg = std::max(time_seg, std::abs(delta[axis] / speeds[axis]));
+		}
+
+		time += time_seg;
+	}
+
+	return std::make_pair(length, time);
+}
+
+
+/**
+ * find paths between several pairs of initial and final positions,
+ * the paths are calculated in parallel using the thread pool
+ * @arg positions (a2_i, a4_i, a2_f, a4_f) angles of each path, in radians
+ * @note must not be called from within a worker thread of the pool
+ */
+InstrumentPaths PathsBuilder::FindPaths(
+	const std::vector<std::array<t_real, 4>>& positions,
+	PathStrategy pathstrategy, bool subdivide_lines, bool deg) const
+{
+	const std::size_t num_paths = positions.size();
+
+	InstrumentPaths results{};
+	results.paths.resize(num_paths);
+	results.lengths.resize(num_paths, 0);
+	results.times.resize(num_paths, 0);
+
+	// the vertices of every path, in radians
+	std::vector<std::vector<t_vec2>> vertices(num_paths);
+
+	// find the path and its vertices for a range of positions
+	auto task = [this, &positions, &results, &vertices, pathstrategy, subdivide_lines](
+		std::size_t begin, std::size_t end, std::size_t /*worker*/)
+	{
+		for(std::size_t idx=begin; idx<end; ++idx)
+		{
+			const std::array<t_real, 4>& pos = positions[idx];
+
+			InstrumentPath path = FindPath(pos[0], pos[1], pos[2], pos[3], pathstrategy);
+			if(path.ok)
+			{
+				vertices[idx] = GetPathVertices(path, subdivide_lines, false);
+				std::tie(results.lengths[idx], results.times[idx]) =
+					GetPathLengthAndTravelTime(vertices[idx], false);
+			}
+
+			results.paths[idx] = std::move(path);
+		}
+	};
+
+	// use the shared thread pool or a temporary one if none has been set
+	std::shared_ptr<ThreadPool> pool = m_threadpool;
+	if(!pool)
+		pool = std::make_shared<ThreadPool>(m_maxnum_threads);
+
+	// the calculation times of the individual paths vary a lot, so use single-item tiles
+	pool->ParallelFor(num_paths, 1, task);
+
+	// flatten the vertex arrays
+	std::size_t num_vertices = 0;
+	for(const std::vector<t_vec2>& path_vertices : vertices)
+		num_vertices += path_vertices.size();
+
+	results.ok.reserve(num_paths);
+	results.vertices.reserve(num_vertices * 2);
+	results.vertex_offsets.reserve(num_paths + 1);
+
+	const t_real conv = deg ? t_real(180) / tl2::pi<t_real> : t_real(1);
+
+	for(std::size_t idx=0; idx<num_paths; ++idx)
+	{
+		// a path without vertices has failed the verification
+		results.ok.push_back(results.paths[idx].ok && vertices[idx].size() != 0);
+		results.vertex_offsets.push_back(results.vertices.size() / 2);
+		results.lengths[idx] *= conv;
+
+		for(const t_vec2& vertex : vertices[idx])
+		{
+			results.vertices.push_back(vertex[0] * conv);
+			results.vertices.push_back(vertex[1] * conv);
+		}
+	}
+
+	results.vertex_offsets.push_back(results.vertices.size() / 2);
+	return results;
+}
+
+
+/**
+ * find paths between the consecutive positions of a scan
+ * @arg positions (a2, a4) angles of the scan points, in radians
+ */
+InstrumentPaths PathsBuilder::FindScanPaths(
+	const std::vector<std::pair<t_real, t_real>>& positions,
+	PathStrategy pathstrategy, bool subdivide_lines, bool deg) const
+{
+	std::vector<std::array<t_real, 4>> path_positions;
+	if(positions.size() >= 2)
+		path_positions.reserve(positions.size() - 1);
+
+	for(std::size_t idx=1; idx<positions.size(); ++idx)
+	{
+		path_positions.emplace_back(std::array<t_real, 4>
+		{
+			positions[idx - 1].first, positions[idx - 1].second,
+			positions[idx].first, positions[idx].second,
+		});
+	}
+
+	return FindPaths(path_positions, pathstrategy, subdivide_lines, deg);
+}
+
+
 /**
  * find the closest point on a bisector path segment
  * @arg vec starting position, in pixel coordinates
@@ -1172,12 +1628,29 @@ PathsBuilder::FindClosestBisector(
  */
 t_real PathsBuilder::GetDistToNearestWall(const t_vec2& vertex) const
 {
-	// get the wall vertices that are closest to the given vertex
-	if(auto nearest_walls = m_wallsindextree.Query(vertex, 1); nearest_walls.size() >= 1)
+	// directly look up the precalculated distance if available
+	if(m_wallsclearance.GetWidth() == m_img.GetWidth() &&
+		m_wallsclearance.GetHeight() == m_img.GetHeight() &&
+		m_wallsclearance.GetWidth() && m_wallsclearance.GetHeight())
+	{
+		// use the pixel nearest to the sub-pixel vertex
+		std::size_t x = static_cast<std::size_t>(std::clamp<t_real>(
+			std::round(vertex[0]), 0, t_real(m_wallsclearance.GetWidth() - 1)));
+		std::size_t y = static_cast<std::size_t>(std::clamp<t_real>(
+			std::round(vertex[1]), 0, t_real(m_wallsclearance.GetHeight() - 1)));
+
+		// colliding pixels are stored with negative distances,
+		// calculate the continuous distance for them below
+		if(t_real dist = m_wallsclearance.GetPixel(x, y); dist >= 0.)
+			return dist;
+	}
+
+	// get the wall vertex that is closest to the given vertex
+	if(auto nearest_wall = m_wallsdistmap.Query(vertex); nearest_wall)
 	{
 		// get angular distance to wall
 		t_vec2 angle = PixelToAngle(vertex, false, false);
-		t_vec2 nearest_wall_angle = PixelToAngle(nearest_walls[0], false, false);
+		t_vec2 nearest_wall_angle = PixelToAngle(*nearest_wall, false, false);
 		t_real dist = GetPathLength(nearest_wall_angle - angle);
 
 		return dist;
@@ -1188,6 +1661,22 @@ t_real PathsBuilder::GetDistToNearestWall(const t_vec2& vertex) const
 }
 
 
+/**
+ * get the angular distance of a voronoi vertex to the nearest wall
+ * @arg idx index of the voronoi vertex
+ * @return angular distance in rad
+ */
+t_real PathsBuilder::GetVoronoiVertexDistToWalls(std::size_t idx) const
+{
+	// use the precalculated distances if they are up-to-date
+	if(idx < m_voro_wall_dists.size() &&
+		m_voro_wall_dists.size() == m_voro_results.GetVoronoiVertices().size())
+		return m_voro_wall_dists[idx];
+
+	return GetDistToNearestWall(m_voro_results.GetVoronoiVertices()[idx]);
+}
+
+
 /**
  * find and remove loops near the retraction points in the path
  * @arg path_vertices in deg or rad
@@ -1388,40 +1877,147 @@ bool PathsBuilder::DoesDirectPathCollide(const t_vec2& vert1, const t_vec2& vert
  */
 bool PathsBuilder::DoesDirectPathCollidePixel(const t_vec2& vert1, const t_vec2& vert2, bool use_min_dist) const
 {
-	t_int last_x = -1;
-	t_int last_y = -1;
+	// colliding pixels have negative distances
+	t_real min_dist = 0.;
+	if(use_min_dist)
+		min_dist = std::max(m_min_angular_dist_to_walls, t_real(0));
+
+	return !IsPathSegmentClearPixel(vert1, vert2, min_dist);
+}
+
+
+/**
+ * check if a path segment keeps the given minimum distance to the walls
+ * @arg vert1 starting angular position of the path, in deg or rad
+ * @arg vert2 ending angular position of the path, in deg or rad
+ * @arg min_dist minimum angular distance to the walls, in rad
+ */
+bool PathsBuilder::IsPathSegmentClear(const t_vec2& vert1, const t_vec2& vert2, t_real min_dist, bool deg) const
+{
+	t_vec2 pix1 = AngleToPixel(vert1, deg, false);
+	t_vec2 pix2 = AngleToPixel(vert2, deg, false);
+
+	return IsPathSegmentClearPixel(pix1, pix2, min_dist);
+}
+
+
+/**
+ * check if a path segment keeps the given minimum distance to the walls
+ * by sphere tracing through the wall distance field: a pixel with a wall distance d
+ * guarantees that all pixels within d - min_dist (minus a pixel diagonal for the
+ * discretisation) also keep the minimum distance, so these can be skipped;
+ * the distance map refers to the wall pixels shifted by one in x direction,
+ * so at least this offset is kept to not skip the colliding pixels themselves
+ * @arg vert1 starting position of the path, in pixels
+ * @arg vert2 ending position of the path, in pixels
+ * @arg min_dist minimum angular distance to the walls, in rad
+ */
+bool PathsBuilder::IsPathSegmentClearPixel(const t_vec2& vert1, const t_vec2& vert2, t_real min_dist) const
+{
+	const std::size_t width = m_img.GetWidth();
+	const std::size_t height = m_img.GetHeight();
 
-	for(t_real t=0.; t<=1.; t+=m_eps_angular)
+	// the path has to be inside the image
+	for(const t_vec2& vert : { vert1, vert2 })
 	{
-		t_int x = (t_int)std::lerp(vert1[0], vert2[0], t);
-		t_int y = (t_int)std::lerp(vert1[1], vert2[1], t);
+		if(vert[0] < 0. || vert[0] >= t_real(width) ||
+			vert[1] < 0. || vert[1] >= t_real(height))
+			return false;
+	}
 
-		// don't check the same pixel again
-		if(last_x == x && last_y == y)
-			continue;
+	// no precalculated wall distances available, check all pixels crossed by the path
+	if(m_wallsclearance.GetWidth() != width || m_wallsclearance.GetHeight() != height)
+	{
+		return !geo::traverse_line_pixels<t_vec2>(vert1, vert2,
+			[this, width, height, min_dist](long x, long y, t_real, t_real) -> bool
+		{
+			// pixels outside the image are only touched at a corner
+			if(x < 0 || y < 0 || x >= long(width) || y >= long(height))
+				return false;
+
+			// TODO: test if collision happens inside epsilon-circles, not just for the pixels
+			if(m_img.GetPixel(x, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
+				return true;
+
+			if(min_dist > 0.)
+			{
+				// reject path if the minimum distance to the walls is undercut
+				t_vec2 pix = tl2::create<t_vec2>({t_real(x), t_real(y)});
+				if(GetDistToNearestWall(pix) < min_dist)
+					return true;
+			}
+
+			return false;
+		});
+	}
 
-		if(x<0 || x>=(t_int)m_img.GetWidth() || y<0 || y>=(t_int)m_img.GetHeight())
-			return true;
+	// length of the path segment and of a pixel diagonal in the path metric
+	const t_vec2 metric = GetPixelMetric();
+	const t_real seg_len = std::sqrt(
+		std::pow(metric[0] * (vert2[0] - vert1[0]), 2) +
+		std::pow(metric[1] * (vert2[1] - vert1[1]), 2));
+	const t_real pix_diag = std::sqrt(metric[0]*metric[0] + metric[1]*metric[1]);
 
-		// TODO: test if collision happens inside epsilon-circles, not just for the pixels
-		if(m_img.GetPixel(x, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
-			return true;
+	min_dist = std::max(min_dist, t_real(0));
+	const t_real min_skip_dist = std::max(min_dist, metric[0]) + pix_diag*(1. + m_eps);
+	bool clear = true;
+	t_real t = 0.;
 
-		if(use_min_dist)
+	while(t < 1.)
+	{
+		// param where the traversal has to stop to jump ahead in free space
+		std::optional<t_real> t_jump;
+
+		// step through the pixels until one with enough clearance to jump ahead is found
+		geo::traverse_line_pixels<t_vec2>(vert1, vert2,
+			[this, width, height, min_dist, min_skip_dist, pix_diag, seg_len, &clear, &t_jump](
+				long x, long y, t_real t_enter, t_real) -> bool
 		{
-			// look for the closest wall
-			t_vec2 pix = tl2::create<t_vec2>({t_real(x), t_real(y)});
-			t_real dist_to_walls = GetDistToNearestWall(pix);
+			// pixels outside the image are only touched at a corner
+			if(x < 0 || y < 0 || x >= long(width) || y >= long(height))
+				return false;
 
-			// reject path if the minimum distance to the walls is undercut
-			if(dist_to_walls < m_min_angular_dist_to_walls)
+			t_real dist = m_wallsclearance.GetPixel(x, y);
+			if(dist < min_dist)
+			{
+				clear = false;
 				return true;
-		}
+			}
+
+			// distance that can be safely skipped along the path
+			t_real skip = dist - min_skip_dist;
+			if(skip > 2.*pix_diag && seg_len > 0.)
+			{
+				t_jump = t_enter + skip / seg_len;
+				return true;
+			}
+
+			return false;
+		}, 1., t, 1.);
 
-		last_x = x;
-		last_y = y;
+		if(!clear || !t_jump)
+			break;
+		t = *t_jump;
 	}
 
-	return false;
+	return clear;
+}
+
+
+/**
+ * check the direct paths from a vertex to several other vertices
+ * @arg vert, verts in pixel coordinates
+ * @return index of the first vertex that can be reached without collision
+ */
+std::optional<std::size_t> PathsBuilder::FindNonCollidingDirectPathPixel(
+	const t_vec2& vert, const std::vector<t_vec2>& verts, bool use_min_dist) const
+{
+	for(std::size_t idx=0; idx<verts.size(); ++idx)
+	{
+		if(!DoesDirectPathCollidePixel(vert, verts[idx], use_min_dist))
+			return idx;
+	}
+
+	return std::nullopt;
 }
 // ----------------------------------------------------------------------------
@@ -32,12 +32,19 @@
 #define __GEO_PATHS_BUILDER_H__
 
 #include <vector>
+#include <unordered_map>
+#include <optional>
+#include <array>
 #include <memory>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <mutex>
 
 #include <boost/signals2/signal.hpp>
 
 #include "src/libs/voronoi_lines.h"
+#include "src/libs/lines.h"
 #include "src/libs/voronoi.h"
 #include "src/libs/img.h"
 #include "src/libs/graphs.h"
@@ -48,6 +55,7 @@
 #include "InstrumentSpace.h"
 #include "TasCalculator.h"
 #include "PathsExporter.h"
+#include "ThreadPool.h"
 
 
 struct InstrumentPath
@@ -56,8 +64,8 @@ struct InstrumentPath
 	bool ok = false;
 
 	// initial and final vertices on path (in pixel coordinates)
-	t_vec2 vec_i;
-	t_vec2 vec_f;
+	t_vec2 vec_i{};
+	t_vec2 vec_f{};
 
 	// is it a direct path from vec_i to vec_f?
 	bool is_direct = false;
@@ -67,7 +75,7 @@ struct InstrumentPath
 	bool is_linear_f = true;
 
 	// indices of the voronoi vertices on the path mesh
-	std::vector<std::size_t> voronoi_indices;
+	std::vector<std::size_t> voronoi_indices{};
 
 	// position parameter along the entry and exit path
 	t_real param_i = 0;
@@ -75,6 +83,66 @@ struct InstrumentPath
 };
 
 
+/**
+ * results of planning several instrument paths at once,
+ * the vertices of all paths are stored in flat arrays
+ */
+struct InstrumentPaths
+{
+	// planned paths
+	std::vector<InstrumentPath> paths{};
+
+	// was a valid path found for the given initial and final positions?
+	std::vector<bool> ok{};
+
+	// interleaved (a4, a2) vertices of all paths
+	std::vector<t_real> vertices{};
+
+	// index of the first vertex of every path, the last entry is the total number of vertices
+	std::vector<std::size_t> vertex_offsets{};
+
+	// angular path lengths and motor travel times
+	std::vector<t_real> lengths{};
+	std::vector<t_real> times{};
+};
+
+
+/**
+ * time-parametrised trajectory along an instrument path
+ */
+struct InstrumentTrajectory
+{
+	// could a trajectory be calculated?
+	bool ok = false;
+
+	// synchronised (a4, a2) waypoints, both motors reach each waypoint at the same time
+	std::vector<t_vec2> vertices{};
+
+	// arrival times and path velocities at the waypoints
+	std::vector<t_real> times{};
+	std::vector<t_real> velocities{};
+
+	// total travel time
+	t_real total_time = 0;
+};
+
+
+/**
+ * results of a path verification
+ */
+struct PathVerification
+{
+	// is the path free of collisions?
+	bool ok = true;
+
+	// first colliding segment, it connects the vertices segment and segment+1
+	std::size_t segment = 0;
+
+	// was the collision found in the check against the full instrument geometry?
+	bool geometry_collision = false;
+};
+
+
 /**
  * strategy for finding the path
  */
@@ -88,6 +156,49 @@ enum class PathStrategy
 };
 
 
+/**
+ * algorithm for finding the shortest path in the voronoi graph
+ */
+enum class PathSearch
+{
+	// full single-source dijkstra search, the variant is set by TASPATHS_SSSP_IMPL
+	DIJKSTRA,
+
+	// a* search directed towards the target vertex
+	ASTAR,
+
+	// dijkstra search from both ends of the path
+	BIDIRECTIONAL,
+};
+
+
+/**
+ * shortest-path tree on the path mesh from an initial instrument position,
+ * it is used to find the paths to many final positions
+ */
+struct InstrumentPathTree
+{
+	// path mesh ok and tree calculated?
+	bool ok = false;
+
+	// initial position allowed and its vertex set? (also needed for direct paths)
+	bool start_ok = false;
+
+	// initial (a2, a4) angles and strategy of the tree
+	t_real a2_i = 0;
+	t_real a4_i = 0;
+	PathStrategy pathstrategy = PathStrategy::SHORTEST;
+
+	// initial vertex (in pixel coordinates) and its retraction voronoi vertex
+	t_vec2 vec_i{};
+	std::size_t idx_i = 0;
+
+	// predecessors and weighted path lengths of all voronoi vertices
+	std::vector<std::optional<std::size_t>> predecessors{};
+	std::vector<t_real> costs{};
+};
+
+
 /**
  * backend to use for contour calculation
  */
@@ -114,6 +225,23 @@ enum class VoronoiBackend
 };
 
 
+/**
+ * sampling of the configuration space
+ */
+enum class ConfigSpaceSampling
+{
+	// calculate every pixel
+	FULL,
+
+	// sample a coarse grid and only subdivide non-uniform cells
+	ADAPTIVE,
+
+	// follow the obstacle boundaries and flood-fill the interiors,
+	// obstacles smaller than a cell that no seed pixel touches are missed
+	BOUNDARY,
+};
+
+
 // pixel values for various configuration space conditions
 #define PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE  0xf0
 #define PATHSBUILDER_PIXEL_VALUE_COLLISION        0xff
@@ -139,14 +267,62 @@ public:
 		std::size_t, std::size_t>;
 
 	// voronoi graph
-	using t_graph = geo::AdjacencyList<t_real>;
+	using t_graph = geo::CompressedAdjacencyList<t_real>;
+	//using t_graph = geo::AdjacencyList<t_real>;
 	//using t_graph = geo::AdjacencyMatrix<t_real>;
 
+	// immutable snapshot of a finished path mesh, see CreatePathMeshSnapshot()
+	using t_pathmesh = std::shared_ptr<const PathsBuilder>;
+
+	// lazily subdivided path vertices, see GetPathVertexRange()
+	using t_pathvertices = geo::subdivided_lines<t_vec2>;
+
 
 protected:
+	// parameters of a configuration space calculation, used for incremental updates
+	struct ConfigSpaceState
+	{
+		// angular steps and ranges as passed to CalculateConfigSpace
+		std::array<t_real, 6> ranges{};
+		std::array<t_real, 3> senses{1, 1, 1};
+
+		// fixed analyser (or monochromator) angle
+		t_real a6{};
+		bool kf_fixed = true;
+
+		// instrument and walls used in the calculation
+		std::size_t instr_version = 0;
+		std::shared_ptr<const WallsCollisionScene> walls{};
+
+		// contours traced from the image, and the pixel region [x0, x1) x [y0, y1)
+		// updated since then, so that only the contours in this region are re-traced
+		std::vector<std::vector<t_contourvec>> contours{};
+		std::optional<std::array<std::size_t, 4>> changed_region{};
+	};
+
+	ConfigSpaceState GetConfigSpaceState(t_real da2, t_real da4,
+		t_real starta2, t_real enda2, t_real starta4, t_real enda4) const;
+
+	// set the instrument angles corresponding to a configuration space pixel
+	void SetConfigSpacePixelAngles(Instrument& instr, std::size_t img_col, std::size_t img_row,
+		t_real a6, bool kf_fixed) const;
+
+	// re-trace the contours in the region changed by UpdateConfigSpace()
+	bool TraceChangedWallContours(std::vector<std::vector<t_contourvec>>& contours) const;
+
+	// calculate the value of a configuration space pixel
+	std::uint8_t CalculateConfigSpacePixel(InstrumentSpace& instrspace,
+		std::size_t img_col, std::size_t img_row, t_real a6, bool kf_fixed) const;
+
 	// get path length, taking into account the motor speeds
 	t_real GetPathLength(const t_vec2& vec) const;
 
+	// get the (a4, a2) motor speeds
+	t_vec2 GetMotorSpeeds() const;
+
+	// get the path length of a pixel step in x and y direction
+	t_vec2 GetPixelMetric() const;
+
 	// check if a position (in angular coordinates) leads to a collision
 	bool DoesPositionCollide(const t_vec2& pos, bool deg = false) const;
 
@@ -156,9 +332,49 @@ protected:
 	bool DoesDirectPathCollidePixel(const t_vec2& vert1, const t_vec2& vert2,
 		bool use_min_dist = true) const;
 
+	// check the direct paths from a vertex to several others, returns the first non-colliding one
+	std::optional<std::size_t> FindNonCollidingDirectPathPixel(const t_vec2& vert,
+		const std::vector<t_vec2>& verts, bool use_min_dist = true) const;
+
+	// check if a path segment keeps a minimum distance to the walls, in pixel coordinates
+	bool IsPathSegmentClearPixel(const t_vec2& vert1, const t_vec2& vert2, t_real min_dist) const;
+
 	// get the angular distance of a vertex to the nearest wall from pixel coordinates
 	t_real GetDistToNearestWall(const t_vec2& vertex) const;
 
+	// calculate and get the wall distances of the voronoi vertices
+	void CalculateVoronoiWallDistances();
+	t_real GetVoronoiVertexDistToWalls(std::size_t idx) const;
+
+	// check if the instrument can be moved to the given (a2, a4) position
+	bool IsInstrumentPositionAllowed(InstrumentSpace& instrspace, t_real a2, t_real a4) const;
+
+	// test if a direct path from the initial to the final position is possible
+	bool IsDirectPathPossible(const InstrumentPath& path) const;
+
+	// find the voronoi vertex to which a position (in pixel coordinates) is retracted
+	std::optional<std::size_t> FindRetractionVertex(const t_vec2& vec) const;
+
+	// get the voronoi graph's edge weights for the given path strategy
+	std::function<std::optional<typename t_graph::t_weight>(std::size_t, std::size_t)>
+	GetVoronoiEdgeWeightFunction(PathStrategy pathstrategy) const;
+
+	// find the shortest path between two voronoi vertices
+	std::pair<bool, std::vector<std::size_t>> FindShortestVoronoiPath(
+		std::size_t idx_initial, std::size_t idx_final, PathStrategy pathstrategy) const;
+
+	// get the voronoi vertices on a path from the predecessors of a graph search
+	static std::pair<bool, std::vector<std::size_t>> GetVoronoiPathFromPredecessors(
+		const std::vector<std::optional<std::size_t>>& predecessors,
+		std::size_t idx_initial, std::size_t idx_final);
+
+	// find the retraction points from the start and end point towards the path mesh
+	bool RetractPathEnds(InstrumentPath& path, PathStrategy pathstrategy) const;
+
+	// check if two path vertices can be connected directly, keeping the original path's wall distance
+	bool IsPathShortcutClear(const std::vector<t_vec2>& path, const std::vector<t_real>& dists,
+		std::size_t idx1, std::size_t idx2, bool deg = false) const;
+
 	// find the closest point on a path segment
 	std::tuple<t_real, t_real, int, t_vec2>
 	FindClosestPointOnBisector(std::size_t idx1, std::size_t idx2, const t_vec2& vec) const;
@@ -167,9 +383,64 @@ protected:
 	std::tuple<t_real, std::pair<std::size_t, std::size_t>, int, bool>
 	FindClosestBisector(std::size_t vert_idx_1, std::size_t vert_idx_2, const t_vec& vert) const;
 
+	// get the file name of a cached path mesh
+	std::string GetPathMeshCacheFile(const std::string& key) const;
+
 	// find and remove loops near the retraction points in the path
 	void RemovePathLoops(std::vector<t_vec2>& path_vertices, bool deg = false, bool reverse = false) const;
 
+	// get the vertices at the corners of an instrument path, before subdivision and verification
+	std::vector<t_vec2> GetPathCornerVertices(const InstrumentPath& path, bool deg = false) const;
+
+	// check a path segment against the walls and optionally against the instrument geometry
+	PathVerification VerifyPathSegment(const t_vec2& vert1, const t_vec2& vert2,
+		InstrumentSpace* instrspace = nullptr, bool deg = false) const;
+
+	/**
+	 * sequentially verify the path segments between the given vertices,
+	 * stopping at the first collision, see VerifyPath()
+	 */
+	template<class t_iter>
+	PathVerification VerifyPathVertices(t_iter iter, t_iter end, bool deg = false) const
+	{
+		if(iter == end)
+			return PathVerification{};
+
+		// instrument copy for the checks against the full geometry
+		std::optional<InstrumentSpace> instrspace;
+		if(m_verifypath_geo_step > 0. && m_instrspace)
+			instrspace.emplace(*m_instrspace);
+
+		t_vec2 vert_prev = *iter;
+
+		// single vertex
+		if(++iter == end)
+			return VerifyPathSegment(vert_prev, vert_prev, instrspace ? &*instrspace : nullptr, deg);
+
+		for(std::size_t seg_idx=0; iter != end; ++iter, ++seg_idx)
+		{
+			const t_vec2& vert = *iter;
+
+			PathVerification result = VerifyPathSegment(vert_prev, vert,
+				instrspace ? &*instrspace : nullptr, deg);
+			if(!result.ok)
+			{
+				result.segment = seg_idx;
+				return result;
+			}
+
+			vert_prev = vert;
+		}
+
+		return PathVerification{};
+	}
+
+	// calculate the configuration space pixels along the obstacle boundaries
+	using t_calc_pixel = std::function<std::uint8_t(InstrumentSpace&, std::size_t, std::size_t)>;
+	bool TraceConfigSpaceBoundaries(ThreadPool& pool,
+		WorkerContexts<InstrumentSpace>& instrspaces, const t_calc_pixel& calc_pixel,
+		std::size_t cell_size, const std::string& msg, geo::Image<std::uint8_t>& img);
+
 
 public:
 	PathsBuilder();
@@ -217,6 +488,9 @@ public:
 	bool CalculateConfigSpace(t_real da2, t_real da4,
 		t_real starta2 = 0., t_real enda2 = tl2::pi<t_real>,
 		t_real starta4 = 0., t_real enda4 = tl2::pi<t_real>);
+	bool UpdateConfigSpace(t_real da2, t_real da4,
+		t_real starta2 = 0., t_real enda2 = tl2::pi<t_real>,
+		t_real starta4 = 0., t_real enda4 = tl2::pi<t_real>);
 	bool CalculateWallsIndexTree();
 	bool CalculateWallContours(bool simplify = true, bool convex_split = false,
 		ContourBackend backend = ContourBackend::INTERNAL);
@@ -225,6 +499,18 @@ public:
 		VoronoiBackend backend = VoronoiBackend::BOOST,
 		bool use_region_function = true);
 
+	// create an immutable copy of the path mesh, the options and the instrument
+	t_pathmesh CreatePathMeshSnapshot() const;
+
+	// atomically replace the published snapshot by a copy of the current path mesh
+	void PublishPathMeshSnapshot();
+
+	// withdraw the published snapshot, e.g. if the path mesh has been invalidated
+	void ResetPathMeshSnapshot();
+
+	// get the most recently published snapshot, can be called from any thread
+	t_pathmesh GetPathMeshSnapshot() const;
+
 	// number of line segment groups -- for scripting interface
 	std::size_t GetNumberOfLineSegmentRegions() const { return m_linegroups.size(); }
 
@@ -240,12 +526,59 @@ public:
 	// ------------------------------------------------------------------------
 	// find a path from an initial (a2, a4) to a final (a2, a4)
 	InstrumentPath FindPath(t_real a2_i, t_real a4_i, t_real a2_f, t_real a4_f,
-		PathStrategy pathstrategy = PathStrategy::SHORTEST);
+		PathStrategy pathstrategy = PathStrategy::SHORTEST) const;
+
+	// calculate the shortest-path tree from an initial (a2, a4) position
+	InstrumentPathTree FindPathTree(t_real a2_i, t_real a4_i,
+		PathStrategy pathstrategy = PathStrategy::SHORTEST) const;
+
+	// find a path from the initial position of a shortest-path tree to a final (a2, a4)
+	InstrumentPath FindPath(const InstrumentPathTree& tree, t_real a2_f, t_real a4_f) const;
+
+	// get the cached shortest-path tree from an initial (a2, a4) position
+	std::shared_ptr<const InstrumentPathTree> GetPathTree(t_real a2_i, t_real a4_i,
+		PathStrategy pathstrategy = PathStrategy::SHORTEST) const;
+	void ClearPathTreeCache() const;
+
+	// find paths between several pairs of initial and final (a2, a4) positions in parallel
+	InstrumentPaths FindPaths(const std::vector<std::array<t_real, 4>>& positions,
+		PathStrategy pathstrategy = PathStrategy::SHORTEST,
+		bool subdivide_lines = false, bool deg = false) const;
+
+	// find paths between the consecutive (a2, a4) positions of a scan in parallel
+	InstrumentPaths FindScanPaths(const std::vector<std::pair<t_real, t_real>>& positions,
+		PathStrategy pathstrategy = PathStrategy::SHORTEST,
+		bool subdivide_lines = false, bool deg = false) const;
 
 	// get individual vertices on an instrument path
 	std::vector<t_vec2> GetPathVertices(const InstrumentPath& path,
 		bool subdivide_lines = false, bool deg = false) const;
 
+	// get the vertices on an instrument path lazily, subdivided at the given spacing
+	t_pathvertices GetPathVertexRange(const InstrumentPath& path,
+		t_real spacing = 0., bool deg = false) const;
+
+	// get the angular length of a path and the time the motors need to travel it
+	std::pair<t_real, t_real> GetPathLengthAndTravelTime(
+		const std::vector<t_vec2>& path, bool deg = false) const;
+
+	// verify the path segments in parallel, reporting the first collision
+	PathVerification VerifyPath(const std::vector<t_vec2>& path, bool deg = false) const;
+
+	// check if a path segment keeps a minimum distance to the walls
+	bool IsPathSegmentClear(const t_vec2& vert1, const t_vec2& vert2,
+		t_real min_dist = 0., bool deg = false) const;
+
+	// shortcut the path vertices as long as the distance to the walls is kept
+	std::vector<t_vec2> ShortcutPath(const std::vector<t_vec2>& path, bool deg = false) const;
+
+	// remove the path vertices that are not needed to keep the distance to the walls
+	std::vector<t_vec2> SimplifyPath(const std::vector<t_vec2>& path, bool deg = false) const;
+
+	// get a velocity- and acceleration-limited trajectory along the path vertices
+	InstrumentTrajectory GetTrajectory(const std::vector<t_vec2>& path,
+		bool shortcut = true, bool deg = false) const;
+
 	// get the distances to the nearest walls for each point of a given path
 	std::vector<t_real> GetDistancesToNearestWall(const std::vector<t_vec2>& path, bool deg = false) const;
 
@@ -277,7 +610,11 @@ public:
 	bool GetRemoveBisectorsBelowMinWallDist() const { return m_remove_bisectors_below_min_wall_dist; }
 
 	unsigned int GetMaxNumThreads() const { return m_maxnum_threads; }
-	void SetMaxNumThreads(unsigned int n) { m_maxnum_threads = n; }
+	void SetMaxNumThreads(unsigned int n);
+
+	// use a thread pool that is shared with other calculations
+	void SetThreadPool(const std::shared_ptr<ThreadPool>& pool) { m_threadpool = pool; }
+	std::shared_ptr<ThreadPool> GetThreadPool();
 
 	bool GetTryDirectPath() const { return m_directpath; }
 	void SetTryDirectPath(bool directpath) { m_directpath = directpath; }
@@ -288,11 +625,26 @@ public:
 	unsigned int GetNumClosestVoronoiVertices() const { return m_num_closest_voronoi_vertices; }
 	void SetNumClosestVoronoiVertices(unsigned int num) { m_num_closest_voronoi_vertices = num; }
 
+	PathSearch GetPathSearch() const { return m_pathsearch; }
+	void SetPathSearch(PathSearch search) { m_pathsearch = search; }
+
 	bool GetVerifyPath() const { return m_verifypath; }
 	void SetVerifyPath(bool verify) { m_verifypath = verify; }
 
+	t_real GetVerifyPathGeometryStep() const { return m_verifypath_geo_step; }
+	void SetVerifyPathGeometryStep(t_real step) { m_verifypath_geo_step = step; }
+
 	bool GetUseMotorSpeeds() const { return m_use_motor_speeds; }
 	void SetUseMotorSpeeds(bool b) { m_use_motor_speeds = b; }
+
+	t_real GetMotorAccelerationTime() const { return m_motor_accel_time; }
+	void SetMotorAccelerationTime(t_real t) { m_motor_accel_time = t; }
+
+	ConfigSpaceSampling GetConfigSpaceSampling() const { return m_cfgspace_sampling; }
+	void SetConfigSpaceSampling(ConfigSpaceSampling sampling) { m_cfgspace_sampling = sampling; }
+
+	t_real GetConfigSpaceCellSize() const { return m_cfgspace_cellsize; }
+	void SetConfigSpaceCellSize(t_real size) { m_cfgspace_cellsize = size; }
 	// ------------------------------------------------------------------------
 
 	// ------------------------------------------------------------------------
@@ -316,15 +668,55 @@ public:
 
 	// export the path to various formats using a visitor
 	bool AcceptExporter(const PathsExporterBase *exporter,
-		const std::vector<t_vec2>& path, bool path_in_rad = false)
+		const std::vector<t_vec2>& path, bool path_in_rad = false) const
 	{ return exporter->Export(this, path, path_in_rad); }
 	// ------------------------------------------------------------------------
 
+	// ------------------------------------------------------------------------
+	// caching of path meshes
+	// ------------------------------------------------------------------------
+	// get a key identifying the path mesh calculated with the given parameters
+	std::string GetPathMeshCacheKey(t_real da2, t_real da4,
+		t_real starta2, t_real enda2,
+		t_real starta4, t_real enda4,
+		const std::string& workflow_options = "") const;
+
+	// save and load the path mesh in binary form
+	bool SavePathMesh(const std::string& filename, const std::string& key = "") const;
+	bool LoadPathMesh(const std::string& filename, const std::string& key = "");
+
+	// directory of the content-addressed cache, disabled if empty
+	const std::string& GetCacheDirectory() const { return m_cachedir; }
+	void SetCacheDirectory(const std::string& dir) { m_cachedir = dir; }
+
+	bool SavePathMeshToCache(const std::string& key) const;
+	bool LoadPathMeshFromCache(const std::string& key);
+	// ------------------------------------------------------------------------
+
 
 private:
 	const InstrumentSpace *m_instrspace{};
 	const TasCalculator *m_tascalc{};
 
+	// copies of the instrument space and calculator owned by a path mesh snapshot
+	std::shared_ptr<const InstrumentSpace> m_instrspace_snapshot{};
+	std::shared_ptr<const TasCalculator> m_tascalc_snapshot{};
+
+	// published path mesh snapshot, only accessed atomically
+	t_pathmesh m_pathmesh{};
+
+	// cache of the last shortest-path tree, copies start with an empty cache
+	struct PathTreeCache
+	{
+		PathTreeCache() = default;
+		PathTreeCache(const PathTreeCache&) {}
+		PathTreeCache& operator=(const PathTreeCache&) { tree.reset(); return *this; }
+
+		std::mutex mtx{};
+		std::shared_ptr<const InstrumentPathTree> tree{};
+	};
+	mutable PathTreeCache m_pathtree_cache{};
+
 	// and-combine return values for calculation progress signal
 	struct combine_sigret
 	{
@@ -353,11 +745,18 @@ private:
 	t_real m_monoScatteringRange[2]{0, tl2::pi<t_real>};
 	t_real m_sampleScatteringRange[2]{0, tl2::pi<t_real>};
 
-	// index tree for wall positions (in pixel coordinates)
-	geo::ClosestPixelTreeResults<t_contourvec> m_wallsindextree{};
+	// closest wall position for every configuration space pixel (in pixel coordinates)
+	geo::ClosestPixelMapResults<t_contourvec> m_wallsdistmap{};
+
+	// distance to the closest wall for every pixel, negative for colliding pixels
+	geo::Image<t_real> m_wallsclearance{};
+	t_real m_max_wall_dist = std::numeric_limits<t_real>::max();
 
 	// wall contours in configuration space
 	geo::Image<std::uint8_t> m_img{};
+
+	// parameters of the last configuration space calculation
+	ConfigSpaceState m_cfgspace_state{};
 	std::vector<std::vector<t_contourvec>> m_wallcontours = {};
 	std::vector<std::vector<t_contourvec>> m_fullwallcontours = {};
 
@@ -372,6 +771,14 @@ private:
 	// voronoi vertices, edges and graph from the line segments
 	geo::VoronoiLinesResults<t_vec2, t_line, t_graph> m_voro_results{};
 
+	// wall distances of the voronoi vertices and their maximum
+	std::vector<t_real> m_voro_wall_dists{};
+	// minimum wall distances along the parabolic voronoi edges, including their end points
+	std::unordered_map<std::pair<std::size_t, std::size_t>, t_real,
+		geo::t_bisector_hash<std::pair<std::size_t, std::size_t>>,
+		geo::t_bisector_equ<std::pair<std::size_t, std::size_t>>> m_voro_edge_wall_dists{};
+	t_real m_max_voro_wall_dist = std::numeric_limits<t_real>::max();
+
 	// general, angular and voronoi edge calculation epsilon
 	t_real m_eps = 1e-3;
 	t_real m_eps_angular = 1e-3;
@@ -388,6 +795,9 @@ private:
 
 	bool m_use_motor_speeds = true;
 
+	// time in which the motors accelerate to their full speeds
+	t_real m_motor_accel_time = 0.5;
+
 	// line segment length for subdivisions
 	t_real m_subdiv_len = 0.1;
 
@@ -403,8 +813,24 @@ private:
 	// check the generated path for collisions
 	bool m_verifypath = true;
 
+	// angular step for re-checking the path against the full instrument geometry, 0: no check
+	t_real m_verifypath_geo_step = 0.;
+
+	// shortest path algorithm for the voronoi graph
+	PathSearch m_pathsearch = PathSearch::ASTAR;
+
+	// sampling of the configuration space and angular size of the coarse grid cells
+	ConfigSpaceSampling m_cfgspace_sampling = ConfigSpaceSampling::FULL;
+	t_real m_cfgspace_cellsize = 4. / t_real(180.) * tl2::pi<t_real>;
+
 	// maximum number of threads to use in calculations
 	unsigned int m_maxnum_threads = 4;
+
+	// persistent thread pool, possibly shared with other calculations
+	std::shared_ptr<ThreadPool> m_threadpool{};
+
+	// directory for cached path meshes
+	std::string m_cachedir{};
 };
 
 #endif
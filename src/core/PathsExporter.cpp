@@ -27,6 +27,21 @@
 #include "PathsExporter.h"
 
 #include <fstream>
+#include <cstdint>
+
+
+/**
+ * get the path vertices to export, the drive commands don't need
+ * the vertices that the simplified path can do without
+ */
+std::vector<t_vec2> PathsExporterBase::GetExportedPath(const PathsBuilder* builder,
+	const std::vector<t_vec2>& path, bool path_in_rad) const
+{
+	if(!m_simplify_path || !builder)
+		return path;
+
+	return builder->SimplifyPath(path, !path_in_rad);
+}
 
 
 /**
@@ -112,7 +127,7 @@ bool PathsExporterNomad::Export(const PathsBuilder* builder,
 	}
 
 	// output motor drive commands
-	for(const auto& vec : path)
+	for(const auto& vec : GetExportedPath(builder, path, path_in_rad))
 	{
 		t_real a4 = vec[0];
 		t_real a2 = vec[1];
@@ -188,7 +203,7 @@ bool PathsExporterNicos::Export(const PathsBuilder* builder,
 
 	// output motor drive commands
 	ofstr << "\n# path vertices\n";
-	for(const auto& vec : path)
+	for(const auto& vec : GetExportedPath(builder, path, path_in_rad))
 	{
 		t_real a4 = vec[0];
 		t_real a2 = vec[1];
@@ -237,3 +252,257 @@ bool PathsExporterNicos::Export(const PathsBuilder* builder,
 	ofstr.flush();
 	return true;
 }
+
+
+/**
+ * stream the paths into a file
+ */
+PathsExporterStream::PathsExporterStream(const std::string& filename, bool binary)
+	: m_ofstr{std::make_unique<std::ofstream>(filename,
+		binary ? std::ios_base::out | std::ios_base::binary : std::ios_base::out)},
+	  m_ostr{m_ofstr.get()}
+{
+}
+
+
+/**
+ * stream the paths into an already opened stream
+ */
+PathsExporterStream::PathsExporterStream(std::ostream& ostr)
+	: m_ostr{&ostr}
+{
+}
+
+
+/**
+ * stream a complete path
+ */
+bool PathsExporterStream::Export(const PathsBuilder* builder,
+	const std::vector<t_vec2>& path, bool path_in_rad) const
+{
+	if(!builder || !IsOk() || m_in_path)
+		return false;
+
+	const t_real conv = path_in_rad ? t_real(180) / tl2::pi<t_real> : t_real(1);
+	const std::vector<t_vec2> exported_path = GetExportedPath(builder, path, path_in_rad);
+
+	WriteBegin(*m_ostr, builder, m_num_paths);
+	for(const t_vec2& vertex : exported_path)
+		WriteVertex(*m_ostr, vertex[0] * conv, vertex[1] * conv);
+	WriteEnd(*m_ostr, exported_path.size());
+
+	++m_num_paths;
+	m_ostr->flush();
+	return IsOk();
+}
+
+
+/**
+ * stream the vertices of a path as they are generated,
+ * without simplifying the path or storing its subdivided vertices
+ * @arg spacing maximum distance between the vertices in degrees, 0 for the builder's subdivision length
+ * @returns false if the path is invalid, nothing is streamed in this case
+ */
+bool PathsExporterStream::ExportPath(const PathsBuilder* builder,
+	const InstrumentPath& path, t_real spacing)
+{
+	if(!builder || !path.ok)
+		return false;
+
+	// the range is empty if the path could not be verified
+	const PathsBuilder::t_pathvertices vertices = builder->GetPathVertexRange(path, spacing, true);
+	if(vertices.empty() || !BeginPath(builder))
+		return false;
+
+	for(const t_vec2& vertex : vertices)
+	{
+		if(!AddVertex(vertex, false))
+			return false;
+	}
+
+	return EndPath();
+}
+
+
+/**
+ * stream all paths of a batch calculation from their flat vertex array,
+ * paths without a solution are streamed without vertices to keep the path indices
+ */
+bool PathsExporterStream::ExportPaths(const PathsBuilder* builder,
+	const InstrumentPaths& paths, bool paths_in_rad)
+{
+	if(!builder || !IsOk() || m_in_path)
+		return false;
+
+	// nothing to export
+	if(paths.ok.empty())
+		return true;
+
+	// check the consistency of the flat arrays
+	if(paths.vertex_offsets.size() != paths.ok.size() + 1)
+		return false;
+	if(paths.vertex_offsets.back() * 2 > paths.vertices.size())
+		return false;
+
+	const t_real conv = paths_in_rad ? t_real(180) / tl2::pi<t_real> : t_real(1);
+
+	for(std::size_t path_idx=0; path_idx<paths.ok.size(); ++path_idx)
+	{
+		const std::size_t vert_begin = paths.vertex_offsets[path_idx];
+		const std::size_t vert_end = paths.vertex_offsets[path_idx + 1];
+		if(vert_end < vert_begin)
+			return false;
+
+		// export the same vertices as Export() for a single path
+		std::vector<t_vec2> path;
+		if(paths.ok[path_idx])
+		{
+			path.reserve(vert_end - vert_begin);
+			for(std::size_t vert_idx=vert_begin; vert_idx<vert_end; ++vert_idx)
+			{
+				path.emplace_back(tl2::create<t_vec2>({
+					paths.vertices[vert_idx*2 + 0],
+					paths.vertices[vert_idx*2 + 1] }));
+			}
+		}
+		const std::vector<t_vec2> exported_path = GetExportedPath(builder, path, paths_in_rad);
+
+		WriteBegin(*m_ostr, builder, m_num_paths);
+		for(const t_vec2& vertex : exported_path)
+			WriteVertex(*m_ostr, vertex[0] * conv, vertex[1] * conv);
+		WriteEnd(*m_ostr, exported_path.size());
+
+		++m_num_paths;
+		if(!IsOk())
+			return false;
+	}
+
+	m_ostr->flush();
+	return IsOk();
+}
+
+
+/**
+ * begin streaming a new path
+ */
+bool PathsExporterStream::BeginPath(const PathsBuilder* builder)
+{
+	if(!builder || !IsOk() || m_in_path)
+		return false;
+
+	WriteBegin(*m_ostr, builder, m_num_paths);
+	m_in_path = true;
+	m_num_vertices = 0;
+	return IsOk();
+}
+
+
+/**
+ * stream a vertex of the current path
+ */
+bool PathsExporterStream::AddVertex(const t_vec2& vertex, bool vertex_in_rad)
+{
+	if(!m_in_path)
+		return false;
+
+	const t_real conv = vertex_in_rad ? t_real(180) / tl2::pi<t_real> : t_real(1);
+
+	WriteVertex(*m_ostr, vertex[0] * conv, vertex[1] * conv);
+	++m_num_vertices;
+	return IsOk();
+}
+
+
+/**
+ * finish streaming the current path
+ */
+bool PathsExporterStream::EndPath()
+{
+	if(!m_in_path)
+		return false;
+
+	WriteEnd(*m_ostr, m_num_vertices);
+	m_in_path = false;
+	++m_num_paths;
+
+	m_ostr->flush();
+	return IsOk();
+}
+
+
+/**
+ * write a value in host byte order
+ */
+template<class t_val>
+static void write_binary(std::ostream& ostr, t_val val)
+{
+	ostr.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+
+void PathsExporterBinary::WriteBegin(std::ostream& ostr,
+	const PathsBuilder* builder, std::size_t path_idx) const
+{
+	double kfix = 0.;
+	std::uint8_t kfix_is_kf = 1;
+
+	if(const TasCalculator* tascalc = builder->GetTasCalculator(); tascalc)
+	{
+		kfix = static_cast<double>(std::get<0>(tascalc->GetKfix()));
+		kfix_is_kf = std::get<1>(tascalc->GetKfix()) ? 1 : 0;
+	}
+
+	write_binary<char>(ostr, 'P');
+	write_binary<std::uint64_t>(ostr, path_idx);
+	write_binary<double>(ostr, kfix);
+	write_binary<std::uint8_t>(ostr, kfix_is_kf);
+}
+
+
+void PathsExporterBinary::WriteVertex(std::ostream& ostr, t_real a4, t_real a2) const
+{
+	write_binary<char>(ostr, 'V');
+	write_binary<double>(ostr, static_cast<double>(a4));
+	write_binary<double>(ostr, static_cast<double>(a2));
+}
+
+
+void PathsExporterBinary::WriteEnd(std::ostream& ostr, std::size_t num_vertices) const
+{
+	write_binary<char>(ostr, 'E');
+	write_binary<std::uint64_t>(ostr, num_vertices);
+}
+
+
+void PathsExporterJsonLines::WriteBegin(std::ostream& ostr,
+	const PathsBuilder* builder, std::size_t path_idx) const
+{
+	// don't change the formatting of the caller's stream
+	const std::streamsize prec = ostr.precision(m_prec);
+	ostr << "{\"type\": \"path\", \"index\": " << path_idx;
+
+	if(const TasCalculator* tascalc = builder->GetTasCalculator(); tascalc)
+	{
+		auto kfix = tascalc->GetKfix();
+
+		ostr << ", \"k_fix\": " << std::get<0>(kfix)
+			<< ", \"k_fix_is_kf\": " << (std::get<1>(kfix) ? "true" : "false");
+	}
+
+	ostr << "}\n";
+	ostr.precision(prec);
+}
+
+
+void PathsExporterJsonLines::WriteVertex(std::ostream& ostr, t_real a4, t_real a2) const
+{
+	const std::streamsize prec = ostr.precision(m_prec);
+	ostr << "{\"type\": \"vertex\", \"a4\": " << a4 << ", \"a2\": " << a2 << "}\n";
+	ostr.precision(prec);
+}
+
+
+void PathsExporterJsonLines::WriteEnd(std::ostream& ostr, std::size_t num_vertices) const
+{
+	ostr << "{\"type\": \"end\", \"num_vertices\": " << num_vertices << "}\n";
+}
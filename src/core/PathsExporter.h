@@ -28,17 +28,24 @@
 
 
 #include <string>
+#include <ostream>
+#include <fstream>
+#include <memory>
 #include "types.h"
 
 
 class PathsBuilder;
+struct InstrumentPath;
+struct InstrumentPaths;
 
 
 enum class PathsExporterFormat
 {
 	RAW,
 	NOMAD,
-	NICOS
+	NICOS,
+	BINARY,
+	JSONL
 };
 
 
@@ -52,6 +59,17 @@ public:
 	virtual bool Export(const PathsBuilder* builder,
 		const std::vector<t_vec2>& path,
 		bool path_in_rad = false) const = 0;
+
+	// only export the path vertices needed to keep the distance to the walls
+	void SetSimplifyPath(bool simplify) { m_simplify_path = simplify; }
+	bool GetSimplifyPath() const { return m_simplify_path; }
+
+protected:
+	std::vector<t_vec2> GetExportedPath(const PathsBuilder* builder,
+		const std::vector<t_vec2>& path, bool path_in_rad) const;
+
+private:
+	bool m_simplify_path = true;
 };
 
 
@@ -112,4 +130,103 @@ private:
 };
 
 
+
+/**
+ * base class for exporters that stream the path vertices one by one,
+ * either to a file or to an already opened stream, e.g. a pipe
+ */
+class PathsExporterStream : public PathsExporterBase
+{
+public:
+	PathsExporterStream(const std::string& filename, bool binary = false);
+	PathsExporterStream(std::ostream& ostr);
+	virtual ~PathsExporterStream() = default;
+
+	// the stream state can't be shared
+	PathsExporterStream(const PathsExporterStream&) = delete;
+	PathsExporterStream& operator=(const PathsExporterStream&) = delete;
+
+	// stream a complete path
+	virtual bool Export(const PathsBuilder* builder,
+		const std::vector<t_vec2>& path,
+		bool path_in_rad = false) const override;
+
+	// stream the subdivided vertices of a path as they are generated
+	bool ExportPath(const PathsBuilder* builder,
+		const InstrumentPath& path, t_real spacing = 0.);
+
+	// stream all paths of a batch calculation
+	bool ExportPaths(const PathsBuilder* builder,
+		const InstrumentPaths& paths, bool paths_in_rad = false);
+
+	// stream the vertices of a path incrementally
+	bool BeginPath(const PathsBuilder* builder);
+	bool AddVertex(const t_vec2& vertex, bool vertex_in_rad = false);
+	bool EndPath();
+
+	bool IsOk() const { return m_ostr && m_ostr->good(); }
+	std::size_t GetNumPaths() const { return m_num_paths; }
+
+protected:
+	// format the path records, the angles are given in degrees
+	virtual void WriteBegin(std::ostream& ostr, const PathsBuilder* builder,
+		std::size_t path_idx) const = 0;
+	virtual void WriteVertex(std::ostream& ostr, t_real a4, t_real a2) const = 0;
+	virtual void WriteEnd(std::ostream& ostr, std::size_t num_vertices) const = 0;
+
+private:
+	std::unique_ptr<std::ofstream> m_ofstr{};
+	std::ostream *m_ostr{};
+
+	// number of streamed paths, also counts the paths streamed by the const Export()
+	mutable std::size_t m_num_paths = 0;
+
+	// number of vertices of the current path, if one has been begun
+	std::size_t m_num_vertices = 0;
+	bool m_in_path = false;
+};
+
+
+/**
+ * export to a compact binary format, in host byte order:
+ *   path:   'P', uint64 path index, float64 k_fix, uint8 k_fix_is_kf
+ *   vertex: 'V', float64 a4 (deg), float64 a2 (deg)
+ *   end:    'E', uint64 number of vertices
+ */
+class PathsExporterBinary : public PathsExporterStream
+{
+public:
+	PathsExporterBinary(const std::string& filename) : PathsExporterStream(filename, true) {}
+	PathsExporterBinary(std::ostream& ostr) : PathsExporterStream(ostr) {}
+	virtual ~PathsExporterBinary() = default;
+
+protected:
+	virtual void WriteBegin(std::ostream& ostr, const PathsBuilder* builder,
+		std::size_t path_idx) const override;
+	virtual void WriteVertex(std::ostream& ostr, t_real a4, t_real a2) const override;
+	virtual void WriteEnd(std::ostream& ostr, std::size_t num_vertices) const override;
+};
+
+
+/**
+ * export to json lines, one record per line
+ */
+class PathsExporterJsonLines : public PathsExporterStream
+{
+public:
+	PathsExporterJsonLines(const std::string& filename) : PathsExporterStream(filename) {}
+	PathsExporterJsonLines(std::ostream& ostr) : PathsExporterStream(ostr) {}
+	virtual ~PathsExporterJsonLines() = default;
+
+protected:
+	virtual void WriteBegin(std::ostream& ostr, const PathsBuilder* builder,
+		std::size_t path_idx) const override;
+	virtual void WriteVertex(std::ostream& ostr, t_real a4, t_real a2) const override;
+	virtual void WriteEnd(std::ostream& ostr, std::size_t num_vertices) const override;
+
+private:
+	std::streamsize m_prec = 10;
+};
+
+
 #endif
@@ -31,17 +31,13 @@
 #include "PathsBuilder.h"
 
 #include <iostream>
-#include <thread>
-#include <future>
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
-
-#include "mingw_hacks.h"
-#include <boost/asio.hpp>
-namespace asio = boost::asio;
-
-using t_task = std::packaged_task<void()>;
-using t_taskptr = std::shared_ptr<t_task>;
+#include <optional>
 
 
 
@@ -63,10 +59,36 @@ PathsBuilder::~PathsBuilder()
 { }
 
 
+/**
+ * set the number of threads, also resizes the thread pool
+ */
+void PathsBuilder::SetMaxNumThreads(unsigned int n)
+{
+	m_maxnum_threads = n;
+
+	if(m_threadpool)
+		m_threadpool->SetNumThreads(n);
+}
+
+
+/**
+ * get the thread pool, creating one if none has been set
+ */
+std::shared_ptr<ThreadPool> PathsBuilder::GetThreadPool()
+{
+	if(!m_threadpool)
+		m_threadpool = std::make_shared<ThreadPool>(m_maxnum_threads);
+
+	return m_threadpool;
+}
+
+
 void PathsBuilder::Clear()
 {
 	//m_img.Clear();
-	m_wallsindextree.Clear();
+	m_wallsdistmap.Clear();
+	m_wallsclearance.Clear();
+	m_max_wall_dist = std::numeric_limits<t_real>::max();
 
 	m_wallcontours.clear();
 	m_fullwallcontours.clear();
@@ -75,6 +97,11 @@ void PathsBuilder::Clear()
 	m_linegroups.clear();
 
 	m_voro_results.Clear();
+	m_voro_wall_dists.clear();
+	m_voro_edge_wall_dists.clear();
+	m_max_voro_wall_dist = std::numeric_limits<t_real>::max();
+
+	ClearPathTreeCache();
 }
 
 
@@ -217,6 +244,9 @@ PathsBuilder::GetWallContours(bool full) const
  */
 void PathsBuilder::StartPathMeshWorkflow()
 {
+	// the previous path mesh is being replaced, so don't answer queries with it anymore
+	ResetPathMeshSnapshot();
+
 	(*m_sigProgress)(CalculationState::STARTED, 1, "Workflow starting.");
 }
 
@@ -226,11 +256,177 @@ void PathsBuilder::StartPathMeshWorkflow()
  */
 void PathsBuilder::FinishPathMeshWorkflow(bool success)
 {
+	// make the new path mesh available to concurrent path queries
+	if(success)
+		PublishPathMeshSnapshot();
+
 	CalculationState state = success ? CalculationState::SUCCEEDED : CalculationState::FAILED;
 	(*m_sigProgress)(state, 1, "Workflow has finished.");
 }
 
 
+/**
+ * create an immutable copy of the path mesh for path queries,
+ * the copy owns its instrument space and calculator, so its const
+ * member functions can be called from several threads while this
+ * builder and its instrument are modified or calculate a new mesh
+ */
+PathsBuilder::t_pathmesh PathsBuilder::CreatePathMeshSnapshot() const
+{
+	std::shared_ptr<PathsBuilder> mesh = std::make_shared<PathsBuilder>(*this);
+
+	// the snapshot has no progress receivers and publishes no snapshots itself
+	mesh->m_sigProgress = std::make_shared<t_sig_progress>();
+	mesh->m_pathmesh.reset();
+
+	// the intermediate results of the mesh calculation are not needed for path queries
+	mesh->m_cfgspace_state = ConfigSpaceState{};
+	mesh->m_wallcontours.clear();
+	mesh->m_fullwallcontours.clear();
+	mesh->m_lines.clear();
+	mesh->m_linegroups.clear();
+	mesh->m_points_outside_regions.clear();
+	mesh->m_inverted_regions.clear();
+
+	if(m_instrspace)
+	{
+		std::shared_ptr<InstrumentSpace> instrspace =
+			std::make_shared<InstrumentSpace>(*m_instrspace);
+
+		// the copy has no signal receivers
+		instrspace->GetInstrument().SetBlockUpdates(true);
+
+		// compile the walls scene now, it is then shared
+		// by the instrument copies of the path queries
+		instrspace->GetWallsCollisionScene();
+
+		mesh->m_instrspace_snapshot = instrspace;
+		mesh->m_instrspace = instrspace.get();
+	}
+
+	if(m_tascalc)
+	{
+		std::shared_ptr<TasCalculator> tascalc =
+			std::make_shared<TasCalculator>(*m_tascalc);
+
+		mesh->m_tascalc_snapshot = tascalc;
+		mesh->m_tascalc = tascalc.get();
+	}
+
+	return mesh;
+}
+
+
+/**
+ * replace the published path mesh snapshot by a copy of the current one,
+ * queries that still hold the previous snapshot keep on using it
+ */
+void PathsBuilder::PublishPathMeshSnapshot()
+{
+	// the snapshot uses the same thread pool for batch queries
+	GetThreadPool();
+
+	t_pathmesh mesh = CreatePathMeshSnapshot();
+	std::atomic_store(&m_pathmesh, mesh);
+}
+
+
+/**
+ * withdraw the published path mesh snapshot, e.g. if it is invalidated by changed walls,
+ * queries that still hold the previous snapshot keep on using it
+ */
+void PathsBuilder::ResetPathMeshSnapshot()
+{
+	std::atomic_store(&m_pathmesh, t_pathmesh{});
+}
+
+
+/**
+ * get the most recently published path mesh snapshot
+ */
+PathsBuilder::t_pathmesh PathsBuilder::GetPathMeshSnapshot() const
+{
+	return std::atomic_load(&m_pathmesh);
+}
+
+
+/**
+ * get the parameters of a configuration space calculation
+ */
+PathsBuilder::ConfigSpaceState PathsBuilder::GetConfigSpaceState(
+	t_real da2, t_real da4,
+	t_real starta2, t_real enda2,
+	t_real starta4, t_real enda4) const
+{
+	ConfigSpaceState state;
+	state.ranges = { da2, da4, starta2, enda2, starta4, enda4 };
+
+	if(m_tascalc)
+	{
+		if(const t_real *sensesCCW = m_tascalc->GetScatteringSenses(); sensesCCW)
+			std::copy(sensesCCW, sensesCCW + state.senses.size(), state.senses.begin());
+
+		// move analysator instead of monochromator?
+		if(!std::get<1>(m_tascalc->GetKfix()))
+			state.kf_fixed = false;
+	}
+
+	if(m_instrspace)
+	{
+		const Instrument& instr = m_instrspace->GetInstrument();
+
+		// analyser angle (alternatively monochromator angle if kf is not fixed)
+		state.a6 = state.kf_fixed
+			? instr.GetAnalyser().GetAxisAngleOut()	      // a6 or
+			: instr.GetMonochromator().GetAxisAngleOut(); // a2
+
+		state.instr_version = m_instrspace->GetInstrumentVersion();
+	}
+
+	return state;
+}
+
+
+/**
+ * set the instrument angles corresponding to a configuration space pixel
+ */
+void PathsBuilder::SetConfigSpacePixelAngles(Instrument& instr,
+	std::size_t img_col, std::size_t img_row, t_real a6, bool kf_fixed) const
+{
+	t_vec2 angle = PixelToAngle(img_col, img_row, false, true);
+	t_real a4 = angle[0];
+	t_real a2 = angle[1];
+	t_real a3 = a4 * 0.5;
+
+	// set scattering angles (a2 and a6 are flipped in case kf is not fixed)
+	instr.GetMonochromator().SetAxisAngleOut(kf_fixed ? a2 : a6);
+	instr.GetSample().SetAxisAngleOut(a4);
+	instr.GetAnalyser().SetAxisAngleOut(kf_fixed ? a6 : a2);
+
+	// set crystal angles (a1 and a5 are flipped in case kf is not fixed)
+	instr.GetMonochromator().SetAxisAngleInternal(kf_fixed ? 0.5*a2 : 0.5*a6);
+	instr.GetSample().SetAxisAngleInternal(a3);
+	instr.GetAnalyser().SetAxisAngleInternal(kf_fixed ? 0.5*a6 : 0.5*a2);
+}
+
+
+/**
+ * calculate the value of a configuration space pixel
+ */
+std::uint8_t PathsBuilder::CalculateConfigSpacePixel(InstrumentSpace& instrspace,
+	std::size_t img_col, std::size_t img_row, t_real a6, bool kf_fixed) const
+{
+	SetConfigSpacePixelAngles(instrspace.GetInstrument(), img_col, img_row, a6, kf_fixed);
+
+	if(!instrspace.CheckAngularLimits())
+		return PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE;
+
+	return instrspace.CheckCollision2D()
+		? PATHSBUILDER_PIXEL_VALUE_COLLISION
+		: PATHSBUILDER_PIXEL_VALUE_NOCOLLISION;
+}
+
+
 /**
  * calculate the obstacle regions in the angular configuration space
  * the monochromator a1/a2 variables can alternatively refer to the analyser a5/a6 in case kf is not fixed
@@ -243,29 +439,24 @@ bool PathsBuilder::CalculateConfigSpace(
 	if(!m_instrspace)
 		return false;
 
+	ConfigSpaceState state = GetConfigSpaceState(da2, da4, starta2, enda2, starta4, enda4);
+	m_cfgspace_state = ConfigSpaceState{};
+
 	m_sampleScatteringRange[0] = starta4;
 	m_sampleScatteringRange[1] = enda4;
 	m_monoScatteringRange[0] = starta2;
 	m_monoScatteringRange[1] = enda2;
 
+	// get the (possibly shared) thread pool
+	std::shared_ptr<ThreadPool> pool = GetThreadPool();
+
 	std::ostringstream ostrmsg;
-	ostrmsg << "Calculating configuration space in " << m_maxnum_threads << " threads...";
+	ostrmsg << "Calculating configuration space in " << pool->GetNumThreads() << " threads...";
 	(*m_sigProgress)(CalculationState::STEP_STARTED, 0, ostrmsg.str());
 
-	const t_real *sensesCCW = nullptr;
-	std::size_t mono_idx = 0;
-	bool kf_fixed = true;
-	if(m_tascalc)
-	{
-		sensesCCW = m_tascalc->GetScatteringSenses();
-
-		// move analysator instead of monochromator?
-		if(!std::get<1>(m_tascalc->GetKfix()))
-		{
-			kf_fixed = false;
-			mono_idx = 2;
-		}
-	}
+	const t_real a6 = state.a6;
+	const bool kf_fixed = state.kf_fixed;
+	const std::size_t mono_idx = kf_fixed ? 0 : 2;
 
 	/*if(kf_fixed)
 		std::cout << "a2 range: ";
@@ -275,24 +466,14 @@ bool PathsBuilder::CalculateConfigSpace(
 		<< " .. " << enda2/tl2::pi<t_real>*180.
 		<< std::endl;*/
 
-	const Instrument& instr = m_instrspace->GetInstrument();
-
-	// analyser angle (alternatively monochromator angle if kf is not fixed)
-	t_real a6 = kf_fixed
-		? instr.GetAnalyser().GetAxisAngleOut()	      // a6 or
-		: instr.GetMonochromator().GetAxisAngleOut(); // a2
-
 	// include scattering senses
-	if(sensesCCW)
-	{
-		da4 *= sensesCCW[1];
-		starta4 *= sensesCCW[1];
-		enda4 *= sensesCCW[1];
+	da4 *= state.senses[1];
+	starta4 *= state.senses[1];
+	enda4 *= state.senses[1];
 
-		da2 *= sensesCCW[mono_idx];
-		starta2 *= sensesCCW[mono_idx];
-		enda2 *= sensesCCW[mono_idx];
-	}
+	da2 *= state.senses[mono_idx];
+	starta2 *= state.senses[mono_idx];
+	enda2 *= state.senses[mono_idx];
 
 	// create colour map and image
 	std::size_t img_w = (enda4-starta4) / da4;
@@ -300,100 +481,790 @@ bool PathsBuilder::CalculateConfigSpace(
 	//std::cout << "Image size: " << img_w << " x " << img_h << "." << std::endl;
 	m_img.Init(img_w, img_h);
 
-	// create thread pool
-	asio::thread_pool pool(m_maxnum_threads);
+	// flatten the static walls once, the compiled scene
+	// is then shared between the instrument space copies
+	state.walls = m_instrspace->GetWallsCollisionScene();
 
-	std::vector<t_taskptr> tasks;
-	tasks.reserve(img_h);
+	// every worker thread clones the instrument space only once,
+	// afterwards only its axis angles are changed
+	WorkerContexts<InstrumentSpace> instrspaces(*m_instrspace, *pool,
+		[](InstrumentSpace& instrspace_cpy)
+	{
+		// the copies have no signal receivers
+		instrspace_cpy.GetInstrument().SetBlockUpdates(true);
+	});
+
+	// calculate the value of a single pixel
+	auto calc_pixel = [this, a6, kf_fixed](InstrumentSpace& instrspace_cpy,
+		std::size_t img_col, std::size_t img_row) -> std::uint8_t
+	{
+		return CalculateConfigSpacePixel(instrspace_cpy, img_col, img_row, a6, kf_fixed);
+	};
+
+	// size of the coarse grid cells in pixels
+	const std::size_t cell_size = std::max<std::size_t>(2, std::size_t(std::min(
+		std::abs(m_cfgspace_cellsize / da4), std::abs(m_cfgspace_cellsize / da2))));
 
+	if(m_cfgspace_sampling == ConfigSpaceSampling::BOUNDARY)
+	{
+		// only calculate the pixels along the obstacle boundaries
+		bool ok = TraceConfigSpaceBoundaries(*pool, instrspaces,
+			calc_pixel, cell_size, ostrmsg.str(), m_img);
+		if(ok)
+			m_cfgspace_state = state;
+
+		(*m_sigProgress)(ok ? CalculationState::STEP_SUCCEEDED : CalculationState::STEP_FAILED,
+			1, ostrmsg.str());
+		return ok;
+	}
 
-	// set image pixels
 	std::atomic<std::size_t> num_pixels = 0;
-	for(std::size_t img_row=0; img_row<img_h; ++img_row)
+	std::size_t num_task_rows = img_h;
+	ThreadPool::t_func task;
+
+	if(m_cfgspace_sampling == ConfigSpaceSampling::ADAPTIVE)
 	{
-		auto task = [this, img_w, img_row, a6, kf_fixed, &num_pixels]()
+		const std::size_t num_cells_x = (img_w + cell_size - 1) / cell_size;
+		const std::size_t num_cells_y = (img_h + cell_size - 1) / cell_size;
+		num_task_rows = num_cells_y;
+
+		// the rows of coarse cells are processed in tiles
+		task = [this, img_w, img_h, cell_size, num_cells_x, &calc_pixel, &num_pixels, &instrspaces](
+			std::size_t cellrow_begin, std::size_t cellrow_end, std::size_t worker)
 		{
-			InstrumentSpace instrspace_cpy = *this->m_instrspace;
+			InstrumentSpace& instrspace_cpy = instrspaces.Get(worker);
 
-			for(std::size_t img_col=0; img_col<img_w; ++img_col)
+			// cache of the already calculated pixels of the current cell
+			constexpr std::uint8_t not_calculated = 0x01;
+			std::vector<std::uint8_t> cache(cell_size * cell_size);
+			std::size_t cell_x0 = 0, cell_y0 = 0;
+
+			auto get_pixel = [&](std::size_t x, std::size_t y) -> std::uint8_t
 			{
-				t_vec2 angle = PixelToAngle(img_col, img_row, false, true);
-				t_real a4 = angle[0];
-				t_real a2 = angle[1];
-				t_real a3 = a4 * 0.5;
+				std::uint8_t& val = cache[(y - cell_y0)*cell_size + (x - cell_x0)];
+				if(val == not_calculated)
+				{
+					val = calc_pixel(instrspace_cpy, x, y);
+					m_img.SetPixel(x, y, val);
+				}
+				return val;
+			};
 
-				Instrument& instr = instrspace_cpy.GetInstrument();
+			// recursively subdivide the area [x0, x1) x [y0, y1) until it is uniform
+			std::function<void(std::size_t, std::size_t, std::size_t, std::size_t)> subdivide;
+			subdivide = [&](std::size_t x0, std::size_t y0, std::size_t x1, std::size_t y1)
+			{
+				if(x0 >= x1 || y0 >= y1)
+					return;
 
-				// set scattering angles (a2 and a6 are flipped in case kf is not fixed)
-				instr.GetMonochromator().SetAxisAngleOut(kf_fixed ? a2 : a6);
-				instr.GetSample().SetAxisAngleOut(a4);
-				instr.GetAnalyser().SetAxisAngleOut(kf_fixed ? a6 : a2);
+				const std::size_t xm = (x0 + x1) / 2;
+				const std::size_t ym = (y0 + y1) / 2;
 
-				// set crystal angles (a1 and a5 are flipped in case kf is not fixed)
-				instr.GetMonochromator().SetAxisAngleInternal(kf_fixed ? 0.5*a2 : 0.5*a6);
-				instr.GetSample().SetAxisAngleInternal(a3);
-				instr.GetAnalyser().SetAxisAngleInternal(kf_fixed ? 0.5*a6 : 0.5*a2);
+				// small areas are fully calculated
+				if(x1 - x0 <= 2 && y1 - y0 <= 2)
+				{
+					for(std::size_t y=y0; y<y1; ++y)
+						for(std::size_t x=x0; x<x1; ++x)
+							get_pixel(x, y);
+					return;
+				}
 
-				// set image value
-				bool angle_ok = instrspace_cpy.CheckAngularLimits();
+				// compare the corner and centre pixels
+				const std::uint8_t val = get_pixel(x0, y0);
+				bool uniform =
+					get_pixel(x1 - 1, y0) == val &&
+					get_pixel(x0, y1 - 1) == val &&
+					get_pixel(x1 - 1, y1 - 1) == val &&
+					get_pixel(xm, ym) == val;
 
-				if(!angle_ok)
+				if(uniform)
 				{
-					m_img.SetPixel(img_col, img_row, PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE);
+					for(std::size_t y=y0; y<y1; ++y)
+						for(std::size_t x=x0; x<x1; ++x)
+							m_img.SetPixel(x, y, val);
+					return;
 				}
-				else
+
+				subdivide(x0, y0, xm, ym);
+				subdivide(xm, y0, x1, ym);
+				subdivide(x0, ym, xm, y1);
+				subdivide(xm, ym, x1, y1);
+			};
+
+			for(std::size_t cell_y=cellrow_begin; cell_y<cellrow_end; ++cell_y)
+			{
+				for(std::size_t cell_x=0; cell_x<num_cells_x; ++cell_x)
 				{
-					bool colliding = instrspace_cpy.CheckCollision2D();
-					m_img.SetPixel(img_col, img_row, colliding ? PATHSBUILDER_PIXEL_VALUE_COLLISION : PATHSBUILDER_PIXEL_VALUE_NOCOLLISION);
-				}
+					cell_x0 = cell_x * cell_size;
+					cell_y0 = cell_y * cell_size;
+					const std::size_t cell_x1 = std::min(cell_x0 + cell_size, img_w);
+					const std::size_t cell_y1 = std::min(cell_y0 + cell_size, img_h);
+
+					std::fill(cache.begin(), cache.end(), not_calculated);
+					subdivide(cell_x0, cell_y0, cell_x1, cell_y1);
 
-				++num_pixels;
+					num_pixels += (cell_x1 - cell_x0) * (cell_y1 - cell_y0);
+				}
 			}
+		};
+	}
+	else
+	{
+		// set all image pixels, the rows are processed in tiles
+		task = [this, img_w, &calc_pixel, &num_pixels, &instrspaces](
+			std::size_t row_begin, std::size_t row_end, std::size_t worker)
+		{
+			InstrumentSpace& instrspace_cpy = instrspaces.Get(worker);
 
-			//std::cout << a2/tl2::pi<t_real>*180. << " finished" << std::endl;
+			for(std::size_t img_row=row_begin; img_row<row_end; ++img_row)
+			{
+				for(std::size_t img_col=0; img_col<img_w; ++img_col)
+				{
+					m_img.SetPixel(img_col, img_row, calc_pixel(instrspace_cpy, img_col, img_row));
+					++num_pixels;
+				}
+			}
 		};
+	}
+
+	// progress is reported from the calling thread
+	pool->ParallelFor(num_task_rows, 0, task, [this, &ostrmsg](t_real progress) -> bool
+	{
+		return (*m_sigProgress)(CalculationState::RUNNING, progress, ostrmsg.str());
+	}, instrspaces.GetPrepareFunc());
 
-		t_taskptr taskptr = std::make_shared<t_task>(task);
-		tasks.push_back(taskptr);
-		asio::post(pool, [taskptr]() { (*taskptr)(); });
+	//std::cout << "pixels total: " << img_h*img_w << ", calculated: " << num_pixels << std::endl;
+	if(num_pixels != img_h*img_w)
+	{
+		(*m_sigProgress)(CalculationState::STEP_FAILED, 1, ostrmsg.str());
+		return false;
 	}
 
+	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, ostrmsg.str());
+
+	m_cfgspace_state = state;
+	return true;
+}
+
+
+/**
+ * calculate the configuration space by only evaluating the pixels along the obstacle boundaries:
+ * the boundaries are located on a coarse grid of seed pixels and followed along the
+ * collision/no-collision interface, the remaining pixels are flood-filled afterwards
+ * @note an obstacle region that lies completely between the seed grid lines is not found,
+ *       so the cell size has to be smaller than the smallest obstacle in configuration space
+ */
+bool PathsBuilder::TraceConfigSpaceBoundaries(ThreadPool& pool,
+	WorkerContexts<InstrumentSpace>& instrspaces, const t_calc_pixel& calc_pixel,
+	std::size_t cell_size, const std::string& msg, geo::Image<std::uint8_t>& img)
+{
+	const std::size_t img_w = img.GetWidth();
+	const std::size_t img_h = img.GetHeight();
+	if(img_w == 0 || img_h == 0)
+		return true;
+
+	// pixel states
+	constexpr std::uint8_t not_calculated = 0x01;
+	constexpr std::uint8_t state_requested = 1 << 0;
+	constexpr std::uint8_t state_expanded = 1 << 1;
 
-	// get results
-	std::size_t num_tasks = tasks.size();
-	// send no more than (100/25) percent update signals
-	std::size_t signal_skip = num_tasks / 25;
+	std::vector<std::uint8_t> values(img_w * img_h, not_calculated);
+	std::vector<std::uint8_t> states(img_w * img_h, 0);
+	std::size_t num_calculated = 0;
 
-	for(std::size_t taskidx=0; taskidx<num_tasks; ++taskidx)
+	// calculate the given pixels in parallel
+	auto calc_pixels = [&](const std::vector<std::size_t>& indices) -> bool
 	{
-		// prevent sending too many progress signals
-		if(signal_skip && (taskidx % signal_skip == 0))
+		num_calculated += indices.size();
+
+		return pool.ParallelFor(indices.size(), 0,
+			[&values, &indices, &instrspaces, &calc_pixel, img_w](
+				std::size_t begin, std::size_t end, std::size_t worker)
 		{
-			if(!(*m_sigProgress)(CalculationState::RUNNING, t_real(taskidx) / t_real(num_tasks), ostrmsg.str()))
+			InstrumentSpace& instrspace_cpy = instrspaces.Get(worker);
+
+			for(std::size_t i=begin; i<end; ++i)
 			{
-				pool.stop();
-				break;
+				std::size_t idx = indices[i];
+				values[idx] = calc_pixel(instrspace_cpy, idx % img_w, idx / img_w);
+			}
+		}, [this, &msg, &num_calculated, img_w, img_h](t_real) -> bool
+		{
+			// report the fraction of calculated pixels
+			return (*m_sigProgress)(CalculationState::RUNNING,
+				t_real(num_calculated) / t_real(img_w * img_h), msg);
+		}, instrspaces.GetPrepareFunc());
+	};
+
+	// request the calculation of a pixel if this hasn't already been done
+	auto request_pixel = [&values, &states](std::size_t idx, std::vector<std::size_t>& indices)
+	{
+		if(values[idx] != not_calculated || (states[idx] & state_requested))
+			return;
+
+		states[idx] |= state_requested;
+		indices.push_back(idx);
+	};
+
+	// seed pixels on the coarse grid, including the last row and column
+	std::vector<std::size_t> seed_xs, seed_ys;
+	for(std::size_t x=0; x<img_w; x+=cell_size)
+		seed_xs.push_back(x);
+	if(seed_xs.back() != img_w - 1)
+		seed_xs.push_back(img_w - 1);
+	for(std::size_t y=0; y<img_h; y+=cell_size)
+		seed_ys.push_back(y);
+	if(seed_ys.back() != img_h - 1)
+		seed_ys.push_back(img_h - 1);
+
+	std::vector<std::size_t> indices;
+	for(std::size_t y : seed_ys)
+		for(std::size_t x : seed_xs)
+			request_pixel(y*img_w + x, indices);
+	if(!calc_pixels(indices))
+		return false;
+
+	// find the grid segments between seeds having different values
+	std::vector<std::pair<std::size_t, std::size_t>> segments;  // start index and index stride
+	std::vector<std::size_t> segment_lengths;
+	for(std::size_t seed_y=0; seed_y<seed_ys.size(); ++seed_y)
+	{
+		for(std::size_t seed_x=0; seed_x<seed_xs.size(); ++seed_x)
+		{
+			std::size_t x = seed_xs[seed_x], y = seed_ys[seed_y];
+			std::size_t idx = y*img_w + x;
+
+			if(seed_x + 1 < seed_xs.size()
+				&& values[idx] != values[y*img_w + seed_xs[seed_x + 1]])
+			{
+				segments.emplace_back(std::make_pair(idx, 1));
+				segment_lengths.push_back(seed_xs[seed_x + 1] - x);
+			}
+
+			if(seed_y + 1 < seed_ys.size()
+				&& values[idx] != values[seed_ys[seed_y + 1]*img_w + x])
+			{
+				segments.emplace_back(std::make_pair(idx, img_w));
+				segment_lengths.push_back(seed_ys[seed_y + 1] - y);
 			}
 		}
+	}
 
-		tasks[taskidx]->get_future().get();
-		//std::cout << taskidx << " / " << num_tasks << " finished" << std::endl;
+	// calculate the pixels along these segments
+	indices.clear();
+	for(std::size_t seg=0; seg<segments.size(); ++seg)
+	{
+		const auto [start, stride] = segments[seg];
+		for(std::size_t i=1; i<segment_lengths[seg]; ++i)
+			request_pixel(start + i*stride, indices);
 	}
+	if(!calc_pixels(indices))
+		return false;
 
-	pool.join();
-	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, ostrmsg.str());
+	// the pixels at the value changes along the segments are the starting points for the tracing
+	std::vector<std::size_t> frontier;
+	auto add_to_frontier = [&states, &frontier](std::size_t idx)
+	{
+		if(states[idx] & state_expanded)
+			return;
 
-	//std::cout << "pixels total: " << img_h*img_w << ", calculated: " << num_pixels << std::endl;
-	return num_pixels == img_h*img_w;
+		states[idx] |= state_expanded;
+		frontier.push_back(idx);
+	};
+
+	for(std::size_t seg=0; seg<segments.size(); ++seg)
+	{
+		const auto [start, stride] = segments[seg];
+		for(std::size_t i=0; i<segment_lengths[seg]; ++i)
+		{
+			std::size_t idx1 = start + i*stride;
+			std::size_t idx2 = idx1 + stride;
+
+			if(values[idx1] != values[idx2])
+			{
+				add_to_frontier(idx1);
+				add_to_frontier(idx2);
+			}
+		}
+	}
+
+	// iterate the 8-neighbourhood of a pixel
+	auto for_each_neighbour = [img_w, img_h](std::size_t idx, auto&& func)
+	{
+		const std::size_t x = idx % img_w, y = idx / img_w;
+
+		for(std::size_t ny=(y > 0 ? y - 1 : y); ny<=std::min(y + 1, img_h - 1); ++ny)
+		{
+			for(std::size_t nx=(x > 0 ? x - 1 : x); nx<=std::min(x + 1, img_w - 1); ++nx)
+			{
+				if(nx != x || ny != y)
+					func(ny*img_w + nx);
+			}
+		}
+	};
+
+	// follow the boundaries: calculate the neighbours of all frontier pixels,
+	// the neighbours of frontier pixels lying on an interface form the next frontier
+	while(frontier.size())
+	{
+		indices.clear();
+		for(std::size_t idx : frontier)
+			for_each_neighbour(idx, [&](std::size_t neighbour) { request_pixel(neighbour, indices); });
+		if(!calc_pixels(indices))
+			return false;
+
+		std::vector<std::size_t> cur_frontier;
+		std::swap(cur_frontier, frontier);
+
+		for(std::size_t idx : cur_frontier)
+		{
+			bool on_interface = false;
+			for_each_neighbour(idx, [&](std::size_t neighbour)
+			{
+				if(values[neighbour] != values[idx])
+					on_interface = true;
+			});
+
+			if(on_interface)
+				for_each_neighbour(idx, add_to_frontier);
+		}
+	}
+
+	// flood-fill the remaining pixels from the calculated ones
+	std::deque<std::size_t> fill_queue;
+	for(std::size_t idx=0; idx<values.size(); ++idx)
+	{
+		if(values[idx] != not_calculated)
+			fill_queue.push_back(idx);
+	}
+
+	while(fill_queue.size())
+	{
+		std::size_t idx = fill_queue.front();
+		fill_queue.pop_front();
+
+		const std::size_t x = idx % img_w, y = idx / img_w;
+		for(std::size_t neighbour : {
+			x > 0 ? idx - 1 : idx, x + 1 < img_w ? idx + 1 : idx,
+			y > 0 ? idx - img_w : idx, y + 1 < img_h ? idx + img_w : idx })
+		{
+			if(values[neighbour] != not_calculated)
+				continue;
+
+			values[neighbour] = values[idx];
+			fill_queue.push_back(neighbour);
+		}
+	}
+
+	// write the image
+	for(std::size_t y=0; y<img_h; ++y)
+		for(std::size_t x=0; x<img_w; ++x)
+			img.SetPixel(x, y, values[y*img_w + x]);
+
+	return true;
+}
+
+
+/**
+ * update the configuration space after walls have been added, moved or removed:
+ * the instrument can only touch a changed wall in the pixels in which one of its axes
+ * gets close enough to the wall's bounding box, so only these pixels are re-calculated,
+ * the contours in the changed region are re-traced afterwards by CalculateWallContours();
+ * falls back to a full calculation if the previous configuration space cannot be reused
+ */
+bool PathsBuilder::UpdateConfigSpace(
+	t_real da2, t_real da4,
+	t_real starta2, t_real enda2,
+	t_real starta4, t_real enda4)
+{
+	if(!m_instrspace)
+		return false;
+
+	const ConfigSpaceState state = GetConfigSpaceState(da2, da4, starta2, enda2, starta4, enda4);
+	const ConfigSpaceState& oldstate = m_cfgspace_state;
+
+	// only the walls may have been changed since the last calculation
+	bool reusable = oldstate.walls
+		&& oldstate.instr_version == state.instr_version
+		&& oldstate.kf_fixed == state.kf_fixed
+		&& oldstate.a6 == state.a6
+		&& oldstate.senses == state.senses
+		&& oldstate.ranges == state.ranges;
+
+	if(!reusable)
+		return CalculateConfigSpace(da2, da4, starta2, enda2, starta4, enda4);
+
+	std::shared_ptr<const WallsCollisionScene> walls = m_instrspace->GetWallsCollisionScene();
+	if(walls == oldstate.walls)
+		return true;
+
+	// get the bounding boxes of the removed and added wall primitives
+	std::vector<std::tuple<t_vec2, t_vec2>> changed_bbs;
+	for(const std::shared_ptr<WallsCollisionScene>& changed_walls : {
+		oldstate.walls->GetDifference(*walls, m_eps),
+		walls->GetDifference(*oldstate.walls, m_eps) })
+	{
+		changed_bbs.insert(changed_bbs.end(), changed_walls->polys_bb.begin(), changed_walls->polys_bb.end());
+		changed_bbs.insert(changed_bbs.end(), changed_walls->circles_bb.begin(), changed_walls->circles_bb.end());
+	}
+
+	std::shared_ptr<ThreadPool> pool = GetThreadPool();
+
+	std::ostringstream ostrmsg;
+	ostrmsg << "Updating configuration space in " << pool->GetNumThreads() << " threads...";
+	(*m_sigProgress)(CalculationState::STEP_STARTED, 0, ostrmsg.str());
+
+	const std::size_t img_w = m_img.GetWidth();
+	const std::size_t img_h = m_img.GetHeight();
+	const t_real a6 = state.a6;
+	const bool kf_fixed = state.kf_fixed;
+
+	// the axis components stay within these distances around the axis positions
+	const Instrument& instr = m_instrspace->GetInstrument();
+	const std::array<t_real, 3> axis_reach
+	{
+		InstrumentSpace::GetAxisReach2D(instr.GetMonochromator()) + m_eps,
+		InstrumentSpace::GetAxisReach2D(instr.GetSample()) + m_eps,
+		InstrumentSpace::GetAxisReach2D(instr.GetAnalyser()) + m_eps,
+	};
+
+	WorkerContexts<InstrumentSpace> instrspaces(*m_instrspace, *pool,
+		[](InstrumentSpace& instrspace_cpy)
+	{
+		instrspace_cpy.GetInstrument().SetBlockUpdates(true);
+	});
+
+	// can any of the axes reach a changed wall at the given instrument angles?
+	auto reaches_changed_walls = [&changed_bbs, &axis_reach](const Instrument& instr_cpy) -> bool
+	{
+		const Axis* axes[] = { &instr_cpy.GetMonochromator(), &instr_cpy.GetSample(), &instr_cpy.GetAnalyser() };
+
+		for(std::size_t axis_idx=0; axis_idx<std::size(axes); ++axis_idx)
+		{
+			const t_vec4 pos = axes[axis_idx]->GetTrafo(AxisAngle::INCOMING) *
+				tl2::create<t_vec4>({0, 0, 0, 1});
+
+			for(const auto& [bbmin, bbmax] : changed_bbs)
+			{
+				// distance between the axis position and the bounding box
+				t_real dx = std::max({ bbmin[0] - pos[0], pos[0] - bbmax[0], t_real(0) });
+				t_real dy = std::max({ bbmin[1] - pos[1], pos[1] - bbmax[1], t_real(0) });
+
+				if(dx*dx + dy*dy <= axis_reach[axis_idx]*axis_reach[axis_idx])
+					return true;
+			}
+		}
+
+		return false;
+	};
+
+	// only re-calculate the pixels in which the instrument can reach the changed walls,
+	// the other pixels cannot have changed
+	geo::Image<std::uint8_t> region;
+	region.Init(img_w, img_h);
+
+	bool ok = pool->ParallelFor(img_h, 0,
+		[this, &region, &instrspaces, &reaches_changed_walls, img_w, a6, kf_fixed](
+			std::size_t row_begin, std::size_t row_end, std::size_t worker)
+	{
+		InstrumentSpace& instrspace_cpy = instrspaces.Get(worker);
+
+		for(std::size_t img_row=row_begin; img_row<row_end; ++img_row)
+		{
+			for(std::size_t img_col=0; img_col<img_w; ++img_col)
+			{
+				if(m_img.GetPixel(img_col, img_row) == PATHSBUILDER_PIXEL_VALUE_FORBIDDEN_ANGLE)
+					continue;
+
+				SetConfigSpacePixelAngles(instrspace_cpy.GetInstrument(), img_col, img_row, a6, kf_fixed);
+				if(!reaches_changed_walls(instrspace_cpy.GetInstrument()))
+					continue;
+
+				region.SetPixel(img_col, img_row, 1);
+				m_img.SetPixel(img_col, img_row, CalculateConfigSpacePixel(
+					instrspace_cpy, img_col, img_row, a6, kf_fixed));
+			}
+		}
+	}, [this, &ostrmsg](t_real progress) -> bool
+	{
+		return (*m_sigProgress)(CalculationState::RUNNING, progress, ostrmsg.str());
+	}, instrspaces.GetPrepareFunc());
+
+	if(!ok)
+	{
+		// the image is only partially updated
+		m_cfgspace_state = ConfigSpaceState{};
+		(*m_sigProgress)(CalculationState::STEP_FAILED, 1, ostrmsg.str());
+		return false;
+	}
+
+	// find the window of re-calculated pixels and add it to the changed region
+	std::array<std::size_t, 4> window{ img_w, img_h, 0, 0 };
+	for(std::size_t y=0; y<img_h; ++y)
+	{
+		for(std::size_t x=0; x<img_w; ++x)
+		{
+			if(!region.GetPixel(x, y))
+				continue;
+
+			window[0] = std::min(window[0], x);
+			window[1] = std::min(window[1], y);
+			window[2] = std::max(window[2], x + 1);
+			window[3] = std::max(window[3], y + 1);
+		}
+	}
+
+	if(window[0] < window[2] && window[1] < window[3])
+	{
+		if(std::optional<std::array<std::size_t, 4>>& changed = m_cfgspace_state.changed_region; changed)
+		{
+			(*changed)[0] = std::min((*changed)[0], window[0]);
+			(*changed)[1] = std::min((*changed)[1], window[1]);
+			(*changed)[2] = std::max((*changed)[2], window[2]);
+			(*changed)[3] = std::max((*changed)[3], window[3]);
+		}
+		else
+		{
+			m_cfgspace_state.changed_region = window;
+		}
+	}
+
+	m_cfgspace_state.walls = walls;
+
+	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, ostrmsg.str());
+	return true;
 }
 
 
 /**
- * save all wall position in an index tree for more efficient position lookup
+ * find the closest wall position for every pixel using a distance transform,
+ * this replaces the index tree previously used for wall position lookups;
+ * distances are measured in the path length metric, i.e. in angular units
+ * scaled by the motor speeds, so that the closest wall is the one closest in time
  */
 bool PathsBuilder::CalculateWallsIndexTree()
 {
-	m_wallsindextree = geo::build_closest_pixel_tree<t_contourvec, decltype(m_img)>(m_img);
+	if(!m_img.GetWidth() || !m_img.GetHeight())
+	{
+		m_wallsdistmap.Clear();
+		m_wallsclearance.Clear();
+		m_max_wall_dist = std::numeric_limits<t_real>::max();
+		return true;
+	}
+
+	const t_vec2 metric = GetPixelMetric();
+	m_wallsdistmap = geo::build_closest_pixel_map<t_contourvec, decltype(m_img)>(
+		m_img, metric[0], metric[1]);
+
+	const std::size_t img_w = m_img.GetWidth();
+	const std::size_t img_h = m_img.GetHeight();
+
+	// the distance map refers to the wall pixels shifted by one in x direction,
+	// so the walls in the last column are missing from it: find the closest
+	// colliding pixels in the last column above and below every row
+	std::vector<std::optional<std::size_t>> lastcol_above(img_h), lastcol_below(img_h);
+	for(std::size_t y=0; y<img_h; ++y)
+	{
+		if(m_img.GetPixel(img_w - 1, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
+			lastcol_above[y] = y;
+		else if(y > 0)
+			lastcol_above[y] = lastcol_above[y - 1];
+	}
+	for(std::size_t y=img_h; y-- > 0;)
+	{
+		if(m_img.GetPixel(img_w - 1, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
+			lastcol_below[y] = y;
+		else if(y + 1 < img_h)
+			lastcol_below[y] = lastcol_below[y + 1];
+	}
+
+	// distance of every pixel to its closest wall,
+	// used for sphere-tracing the clearance along path segments
+	m_wallsclearance.Init(img_w, img_h);
+	m_max_wall_dist = 0.;
+	for(std::size_t y=0; y<img_h; ++y)
+	{
+		for(std::size_t x=0; x<img_w; ++x)
+		{
+			t_real dist = std::numeric_limits<t_real>::max();
+
+			if(m_img.GetPixel(x, y) != PATHSBUILDER_PIXEL_VALUE_NOCOLLISION)
+			{
+				dist = -1.;
+			}
+			else
+			{
+				if(auto idx = m_wallsdistmap.GetClosestIndex(x, y); idx != m_wallsdistmap.no_pixel)
+				{
+					t_real dx = metric[0] * (t_real(idx % img_w) - t_real(x));
+					t_real dy = metric[1] * (t_real(idx / img_w) - t_real(y));
+					dist = std::sqrt(dx*dx + dy*dy);
+				}
+
+				// walls in the last column, all having the same x distance
+				for(const std::optional<std::size_t>& lastcol_y : { lastcol_above[y], lastcol_below[y] })
+				{
+					if(!lastcol_y)
+						continue;
+
+					t_real dx = metric[0] * (t_real(img_w - 1) - t_real(x));
+					t_real dy = metric[1] * (t_real(*lastcol_y) - t_real(y));
+					dist = std::min(dist, std::sqrt(dx*dx + dy*dy));
+				}
+			}
+
+			m_wallsclearance.SetPixel(x, y, dist);
+			m_max_wall_dist = std::max(m_max_wall_dist, dist);
+		}
+	}
+
+	CalculateVoronoiWallDistances();
+	return true;
+}
+
+
+/**
+ * calculate the wall distances of all voronoi vertices and parabolic edges once,
+ * so that the path search doesn't need to look them up for every edge
+ */
+void PathsBuilder::CalculateVoronoiWallDistances()
+{
+	const auto& voro_vertices = m_voro_results.GetVoronoiVertices();
+
+	m_voro_wall_dists.clear();
+	m_voro_wall_dists.reserve(voro_vertices.size());
+	m_max_voro_wall_dist = 0.;
+
+	for(const t_vec2& vertex : voro_vertices)
+	{
+		t_real dist = GetDistToNearestWall(vertex);
+		m_voro_wall_dists.push_back(dist);
+		m_max_voro_wall_dist = std::max(m_max_voro_wall_dist, dist);
+	}
+
+	if(m_voro_wall_dists.empty())
+		m_max_voro_wall_dist = std::numeric_limits<t_real>::max();
+
+	// the wall distance along a parabolic edge can have its minimum between the end points
+	m_voro_edge_wall_dists.clear();
+	m_voro_edge_wall_dists.reserve(m_voro_results.GetParabolicEdges().size());
+
+	for(const auto& [edge, points] : m_voro_results.GetParabolicEdges())
+	{
+		auto [idx1, idx2] = edge;
+		if(idx1 >= m_voro_wall_dists.size() || idx2 >= m_voro_wall_dists.size())
+			continue;
+
+		t_real min_dist = std::min(m_voro_wall_dists[idx1], m_voro_wall_dists[idx2]);
+		for(const t_vec2& point : points)
+			min_dist = std::min(min_dist, GetDistToNearestWall(point));
+
+		m_voro_edge_wall_dists.emplace(edge, min_dist);
+	}
+
+	// the cached shortest-path tree belongs to the previous path mesh
+	ClearPathTreeCache();
+}
+
+
+/**
+ * re-trace only the contours in the region changed by UpdateConfigSpace(), the other contours
+ * are kept from the last tracing; all contours are ordered by their starting pixels, i.e. their
+ * last vertices, in the same way as they are found by a full geo::trace_contour() run
+ * @returns false if the contours need to be fully traced
+ */
+bool PathsBuilder::TraceChangedWallContours(std::vector<std::vector<t_contourvec>>& contours) const
+{
+	const ConfigSpaceState& state = m_cfgspace_state;
+	if(!state.changed_region || state.contours.empty())
+		return false;
+
+	const std::size_t img_w = m_img.GetWidth();
+	const std::size_t img_h = m_img.GetHeight();
+
+	// the contours passing through the neighbouring pixels of the changed region can also change
+	auto [x0, y0, x1, y1] = *state.changed_region;
+	x0 = x0 > 0 ? x0 - 1 : 0;
+	y0 = y0 > 0 ? y0 - 1 : 0;
+	x1 = std::min(x1 + 1, img_w);
+	y1 = std::min(y1 + 1, img_h);
+
+	// find the obstacles that are connected to the changed region
+	geo::Image<std::uint8_t> changed_img;
+	changed_img.Init(img_w, img_h);
+	std::deque<std::size_t> fill_queue;
+
+	auto add_pixel = [this, &changed_img, &fill_queue, img_w](std::size_t x, std::size_t y)
+	{
+		if(m_img.GetPixel(x, y) == PATHSBUILDER_PIXEL_VALUE_NOCOLLISION || changed_img.GetPixel(x, y))
+			return;
+
+		changed_img.SetPixel(x, y, PATHSBUILDER_PIXEL_VALUE_COLLISION);
+		fill_queue.push_back(y*img_w + x);
+	};
+
+	for(std::size_t y=y0; y<y1; ++y)
+		for(std::size_t x=x0; x<x1; ++x)
+			add_pixel(x, y);
+
+	// the contour tracing follows the 8-neighbourhood
+	while(fill_queue.size())
+	{
+		const std::size_t x = fill_queue.front() % img_w;
+		const std::size_t y = fill_queue.front() / img_w;
+		fill_queue.pop_front();
+
+		for(std::size_t ny = (y > 0 ? y - 1 : y); ny <= y + 1 && ny < img_h; ++ny)
+			for(std::size_t nx = (x > 0 ? x - 1 : x); nx <= x + 1 && nx < img_w; ++nx)
+				add_pixel(nx, ny);
+	}
+
+	// keep the contours which don't belong to the changed obstacles
+	std::vector<std::vector<t_contourvec>> kept_contours;
+	kept_contours.reserve(state.contours.size());
+
+	for(std::size_t contouridx=0; contouridx<state.contours.size(); ++contouridx)
+	{
+		const std::vector<t_contourvec>& contour = state.contours[contouridx];
+
+		bool changed = std::any_of(contour.begin(), contour.end(),
+			[&changed_img, x0, y0, x1, y1](const t_contourvec& vec) -> bool
+		{
+			const std::size_t x = vec[0], y = vec[1];
+			return (x >= x0 && x < x1 && y >= y0 && y < y1) || changed_img.GetPixel(x, y);
+		});
+
+		if(!changed)
+			kept_contours.push_back(contour);
+		else if(contouridx == 0)
+			return false;  // the first contour has a special role, see CalculateLineSegments()
+	}
+
+	std::vector<std::vector<t_contourvec>> changed_contours =
+		geo::trace_contour<t_contourvec, decltype(changed_img)>(changed_img);
+
+	// compare the starting pixels of two contours
+	auto is_traced_before = [](const std::vector<t_contourvec>& contour1,
+		const std::vector<t_contourvec>& contour2) -> bool
+	{
+		const t_contourvec& start1 = contour1.back();
+		const t_contourvec& start2 = contour2.back();
+
+		return start1[1] < start2[1] || (start1[1] == start2[1] && start1[0] < start2[0]);
+	};
+
+	// a new contour would become the first one
+	if(kept_contours.empty() || (changed_contours.size() &&
+		is_traced_before(changed_contours.front(), kept_contours.front())))
+		return false;
+
+	contours.clear();
+	contours.reserve(kept_contours.size() + changed_contours.size());
+	std::merge(
+		std::make_move_iterator(kept_contours.begin()), std::make_move_iterator(kept_contours.end()),
+		std::make_move_iterator(changed_contours.begin()), std::make_move_iterator(changed_contours.end()),
+		std::back_inserter(contours), is_traced_before);
+
 	return true;
 }
 
@@ -408,7 +1279,16 @@ bool PathsBuilder::CalculateWallContours(bool simplify, bool convex_split, Conto
 
 	if(backend == ContourBackend::INTERNAL)
 	{
-		m_wallcontours = geo::trace_contour<t_contourvec, decltype(m_img)>(m_img);
+		// only re-trace the contours changed by UpdateConfigSpace() if possible
+		if(!TraceChangedWallContours(m_wallcontours))
+			m_wallcontours = geo::trace_contour<t_contourvec, decltype(m_img)>(m_img);
+
+		// keep the traced contours for the next update
+		if(m_cfgspace_state.walls)
+		{
+			m_cfgspace_state.contours = m_wallcontours;
+			m_cfgspace_state.changed_region.reset();
+		}
 	}
 #ifdef USE_OCV
 	else if(backend == ContourBackend::OCV)
@@ -678,6 +1558,8 @@ bool PathsBuilder::CalculateVoronoi(bool group_lines, VoronoiBackend backend,
 		return false;
 	}
 
+	CalculateVoronoiWallDistances();
+
 	(*m_sigProgress)(CalculationState::STEP_SUCCEEDED, 1, message);
 	return true;
 }
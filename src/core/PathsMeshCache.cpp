@@ -0,0 +1,800 @@
+/**
+ * content-addressed cache for path meshes
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+/*
+ * The path mesh files consist of a header followed by a fixed sequence of arrays.
+ * Every array is stored as a 64 bit element count followed by the raw elements
+ * in native byte order, padded to a multiple of 8 bytes, so that all arrays
+ * are 8-byte aligned. The wall distances are not stored, they are calculated
+ * again after loading.
+ */
+
+#include "PathsBuilder.h"
+
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <iomanip>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+namespace pt = boost::property_tree;
+
+
+// file identifiers
+#define PATHMESH_MAGIC          "TASPMESH"
+#define PATHMESH_VERSION        1
+#define PATHMESH_BYTEORDER      0x01020304u
+#define PATHMESH_FILE_EXT       ".taspathsmesh"
+
+// marker for unset optional indices
+static constexpr std::uint64_t pathmesh_no_index = std::numeric_limits<std::uint64_t>::max();
+
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+/**
+ * 64 bit fnv-1a hash, stable between program runs
+ * @see https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+ */
+class PathMeshHash
+{
+public:
+	void Add(const void* data, std::size_t len)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+		for(std::size_t idx=0; idx<len; ++idx)
+		{
+			m_hash ^= bytes[idx];
+			m_hash *= 0x100000001b3ull;
+		}
+	}
+
+	template<class T> requires std::is_arithmetic_v<T>
+	void Add(T val)
+	{
+		Add(&val, sizeof(val));
+	}
+
+	void Add(const std::string& str)
+	{
+		Add<std::uint64_t>(str.length());
+		Add(str.data(), str.length());
+	}
+
+	std::uint64_t Get() const { return m_hash; }
+
+
+private:
+	std::uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+
+/**
+ * writes the arrays of a path mesh file
+ */
+class PathMeshWriter
+{
+public:
+	PathMeshWriter(std::ostream& ostr) : m_ostr{ostr} {}
+
+	template<class T> requires std::is_trivially_copyable_v<T>
+	void Write(const T& val)
+	{
+		WriteArray(&val, 1, false);
+	}
+
+	template<class T> requires std::is_trivially_copyable_v<T>
+	void WriteArray(const T* vals, std::size_t num, bool write_count = true)
+	{
+		if(write_count)
+		{
+			std::uint64_t count = num;
+			m_ostr.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		}
+
+		const std::size_t len = num * sizeof(T);
+		m_ostr.write(reinterpret_cast<const char*>(vals), len);
+
+		// pad to 8 bytes
+		const char padding[8]{};
+		if(len % 8)
+			m_ostr.write(padding, 8 - len % 8);
+	}
+
+	void WriteString(const std::string& str)
+	{
+		WriteArray(str.data(), str.length());
+	}
+
+	bool IsOk() const { return m_ostr.good(); }
+
+
+private:
+	std::ostream& m_ostr;
+};
+
+
+/**
+ * reads the arrays of a path mesh file from a memory buffer
+ */
+class PathMeshReader
+{
+public:
+	PathMeshReader(const char* data, std::size_t len) : m_data{data}, m_len{len} {}
+
+	template<class T> requires std::is_trivially_copyable_v<T>
+	bool Read(T& val)
+	{
+		return ReadElements(&val, 1);
+	}
+
+	template<class T> requires std::is_trivially_copyable_v<T>
+	bool ReadArray(std::vector<T>& vals)
+	{
+		std::uint64_t count = 0;
+		if(!Read(count) || count > (m_len - m_pos) / sizeof(T))
+			return false;
+
+		vals.resize(count);
+		return ReadElements(vals.data(), count);
+	}
+
+	bool ReadString(std::string& str)
+	{
+		std::vector<char> chars;
+		if(!ReadArray(chars))
+			return false;
+
+		str.assign(chars.begin(), chars.end());
+		return true;
+	}
+
+
+protected:
+	template<class T>
+	bool ReadElements(T* vals, std::size_t num)
+	{
+		const std::size_t len = num * sizeof(T);
+		const std::size_t padded_len = (len + 7) / 8 * 8;
+		if(padded_len > m_len - m_pos)
+			return false;
+
+		if(len)
+			std::memcpy(reinterpret_cast<void*>(vals), m_data + m_pos, len);
+		m_pos += padded_len;
+		return true;
+	}
+
+
+private:
+	const char* m_data{};
+	std::size_t m_len{};
+	std::size_t m_pos{};
+};
+
+
+/**
+ * remove the current axis angles from the instrument definition,
+ * as they don't influence the path mesh
+ */
+static void remove_axis_angles(pt::ptree& prop)
+{
+	for(const char* key : { "angle_in", "angle_internal", "angle_out" })
+		prop.erase(key);
+
+	for(auto& child : prop)
+		remove_axis_angles(child.second);
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// path mesh cache
+// ----------------------------------------------------------------------------
+/**
+ * get a key identifying the path mesh calculated with the given parameters,
+ * the workflow options describe the arguments passed to the calculation steps
+ */
+std::string PathsBuilder::GetPathMeshCacheKey(
+	t_real da2, t_real da4,
+	t_real starta2, t_real enda2,
+	t_real starta4, t_real enda4,
+	const std::string& workflow_options) const
+{
+	PathMeshHash hash;
+	hash.Add<std::uint32_t>(PATHMESH_VERSION);
+
+	// instrument and walls
+	if(m_instrspace)
+	{
+		// the floor has no influence on the path mesh
+		pt::ptree prop = m_instrspace->Save();
+		if(auto space = prop.get_child_optional(FILE_BASENAME "instrument_space"); space)
+			space->erase("floor");
+		remove_axis_angles(prop);
+
+		std::ostringstream ostr;
+		pt::write_xml(ostr, prop);
+		hash.Add(ostr.str());
+	}
+
+	// angular ranges and fixed angles
+	const ConfigSpaceState state = GetConfigSpaceState(da2, da4, starta2, enda2, starta4, enda4);
+	for(t_real val : state.ranges)
+		hash.Add(val);
+	for(t_real val : state.senses)
+		hash.Add(val);
+	hash.Add(state.a6);
+	hash.Add(state.kf_fixed);
+
+	// options having an influence on the path mesh
+	hash.Add(m_eps);
+	hash.Add(m_eps_angular);
+	hash.Add(m_voroedge_eps);
+	hash.Add(m_min_angular_dist_to_walls);
+
+	// the wall distances and the bisector removal are measured in the motor-speed metric
+	hash.Add(m_use_motor_speeds);
+	if(m_use_motor_speeds && m_instrspace)
+	{
+		const t_vec2 speeds = GetMotorSpeeds();
+		hash.Add(speeds[0]);
+		hash.Add(speeds[1]);
+	}
+	hash.Add(m_remove_bisectors_below_min_wall_dist);
+	hash.Add(m_simplify_mindist);
+	hash.Add(static_cast<int>(m_cfgspace_sampling));
+	hash.Add(m_cfgspace_cellsize);
+	hash.Add(workflow_options);
+
+	std::ostringstream ostrKey;
+	ostrKey << std::hex << std::setw(16) << std::setfill('0') << hash.Get();
+	return ostrKey.str();
+}
+
+
+/**
+ * save the configuration space image, contours, line segments and voronoi results
+ */
+bool PathsBuilder::SavePathMesh(const std::string& filename, const std::string& key) const
+{
+	if(!m_img.GetWidth() || !m_img.GetHeight())
+		return false;
+
+	// write to a temporary file first, so that no incomplete files are left behind
+	const std::string tmpfilename = filename + ".tmp";
+	std::ofstream ofstr(tmpfilename, std::ios_base::binary);
+	if(!ofstr)
+		return false;
+
+	PathMeshWriter writer(ofstr);
+
+	// header
+	writer.WriteArray(PATHMESH_MAGIC, 8, false);
+	writer.Write<std::uint32_t>(PATHMESH_VERSION);
+	writer.Write<std::uint32_t>(PATHMESH_BYTEORDER);
+	writer.WriteString(key);
+
+	// parameters
+	const ConfigSpaceState& state = m_cfgspace_state;
+	writer.WriteArray(state.ranges.data(), state.ranges.size());
+	writer.WriteArray(state.senses.data(), state.senses.size());
+	writer.Write<t_real>(state.a6);
+	writer.Write<std::uint64_t>(state.kf_fixed);
+	writer.WriteArray(m_sampleScatteringRange, 2);
+	writer.WriteArray(m_monoScatteringRange, 2);
+
+	// configuration space image
+	writer.Write<std::uint64_t>(m_img.GetWidth());
+	writer.Write<std::uint64_t>(m_img.GetHeight());
+	{
+		std::vector<std::uint8_t> pixels;
+		pixels.reserve(m_img.GetWidth() * m_img.GetHeight());
+		for(std::size_t y=0; y<m_img.GetHeight(); ++y)
+			for(std::size_t x=0; x<m_img.GetWidth(); ++x)
+				pixels.push_back(m_img.GetPixel(x, y));
+		writer.WriteArray(pixels.data(), pixels.size());
+	}
+
+	// wall contours
+	auto write_contours = [&writer](const std::vector<std::vector<t_contourvec>>& contours)
+	{
+		writer.Write<std::uint64_t>(contours.size());
+
+		for(const auto& contour : contours)
+		{
+			std::vector<std::int64_t> coords;
+			coords.reserve(contour.size() * 2);
+			for(const t_contourvec& vec : contour)
+			{
+				coords.push_back(vec[0]);
+				coords.push_back(vec[1]);
+			}
+			writer.WriteArray(coords.data(), coords.size());
+		}
+	};
+
+	write_contours(m_wallcontours);
+	write_contours(m_fullwallcontours);
+
+	// line segments and groups
+	{
+		std::vector<t_real> coords;
+		coords.reserve(m_lines.size() * 4);
+		for(const t_line& line : m_lines)
+		{
+			for(const t_vec2& vec : { std::get<0>(line), std::get<1>(line) })
+			{
+				coords.push_back(vec[0]);
+				coords.push_back(vec[1]);
+			}
+		}
+		writer.WriteArray(coords.data(), coords.size());
+
+		std::vector<std::uint64_t> groups;
+		groups.reserve(m_linegroups.size() * 2);
+		for(const auto& [begin, end] : m_linegroups)
+		{
+			groups.push_back(begin);
+			groups.push_back(end);
+		}
+		writer.WriteArray(groups.data(), groups.size());
+
+		std::vector<t_real> points;
+		points.reserve(m_points_outside_regions.size() * 2);
+		for(const t_vec2& vec : m_points_outside_regions)
+		{
+			points.push_back(vec[0]);
+			points.push_back(vec[1]);
+		}
+		writer.WriteArray(points.data(), points.size());
+
+		std::vector<std::uint8_t> inverted(m_inverted_regions.begin(), m_inverted_regions.end());
+		writer.WriteArray(inverted.data(), inverted.size());
+	}
+
+	// voronoi vertices
+	{
+		const auto& verts = m_voro_results.GetVoronoiVertices();
+
+		std::vector<t_real> coords;
+		coords.reserve(verts.size() * 2);
+		for(const t_vec2& vec : verts)
+		{
+			coords.push_back(vec[0]);
+			coords.push_back(vec[1]);
+		}
+		writer.WriteArray(coords.data(), coords.size());
+	}
+
+	// linear voronoi bisectors
+	{
+		const auto& edges = m_voro_results.GetLinearEdgesVec();
+
+		std::vector<t_real> coords;
+		std::vector<std::uint64_t> indices;
+		coords.reserve(edges.size() * 4);
+		indices.reserve(edges.size() * 2);
+
+		for(const auto& [line, idx1, idx2] : edges)
+		{
+			for(const t_vec2& vec : { std::get<0>(line), std::get<1>(line) })
+			{
+				coords.push_back(vec[0]);
+				coords.push_back(vec[1]);
+			}
+
+			indices.push_back(idx1 ? *idx1 : pathmesh_no_index);
+			indices.push_back(idx2 ? *idx2 : pathmesh_no_index);
+		}
+
+		writer.WriteArray(coords.data(), coords.size());
+		writer.WriteArray(indices.data(), indices.size());
+	}
+
+	// parabolic voronoi bisectors
+	{
+		const auto& edges = m_voro_results.GetParabolicEdgesVec();
+		writer.Write<std::uint64_t>(edges.size());
+
+		for(const auto& [points, idx1, idx2] : edges)
+		{
+			std::uint64_t indices[] = { idx1, idx2 };
+			writer.WriteArray(indices, 2);
+
+			std::vector<t_real> coords;
+			coords.reserve(points.size() * 2);
+			for(const t_vec2& vec : points)
+			{
+				coords.push_back(vec[0]);
+				coords.push_back(vec[1]);
+			}
+			writer.WriteArray(coords.data(), coords.size());
+		}
+	}
+
+	// voronoi graph
+	{
+		const t_graph& graph = m_voro_results.GetVoronoiGraph();
+		const std::size_t num_verts = graph.GetNumVertices();
+		writer.Write<std::uint64_t>(num_verts);
+
+		std::vector<std::uint64_t> edge_indices;
+		std::vector<t_real> edge_weights;
+
+		for(std::size_t vertidx=0; vertidx<num_verts; ++vertidx)
+		{
+			writer.WriteString(graph.GetVertexIdent(vertidx));
+
+			// edges in the order in which they have to be inserted
+			const auto neighbours = graph.GetNeighbours(vertidx);
+			for(auto iter = neighbours.rbegin(); iter != neighbours.rend(); ++iter)
+			{
+				edge_indices.push_back(vertidx);
+				edge_indices.push_back(*iter);
+				edge_weights.push_back(*graph.GetWeight(vertidx, *iter));
+			}
+		}
+
+		writer.WriteArray(edge_indices.data(), edge_indices.size());
+		writer.WriteArray(edge_weights.data(), edge_weights.size());
+	}
+
+	bool ok = writer.IsOk();
+	ofstr.close();
+
+	std::error_code err;
+	if(ok)
+		std::filesystem::rename(tmpfilename, filename, err);
+	if(!ok || err)
+	{
+		std::filesystem::remove(tmpfilename, err);
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * load the configuration space image, contours, line segments and voronoi results,
+ * if a key is given, it has to match the one stored in the file
+ */
+bool PathsBuilder::LoadPathMesh(const std::string& filename, const std::string& key)
+{
+	// read the whole file
+	std::ifstream ifstr(filename, std::ios_base::binary | std::ios_base::ate);
+	if(!ifstr)
+		return false;
+
+	const std::streamsize filelen = ifstr.tellg();
+	if(filelen <= 0)
+		return false;
+
+	std::vector<char> data(filelen);
+	ifstr.seekg(0, std::ios_base::beg);
+	if(!ifstr.read(data.data(), filelen))
+		return false;
+
+	PathMeshReader reader(data.data(), data.size());
+
+	// header
+	char magic[8]{};
+	std::uint32_t version = 0, byteorder = 0;
+	std::string filekey;
+	if(!reader.Read(magic) || std::memcmp(magic, PATHMESH_MAGIC, 8) != 0)
+		return false;
+	if(!reader.Read(version) || version != PATHMESH_VERSION)
+		return false;
+	if(!reader.Read(byteorder) || byteorder != PATHMESH_BYTEORDER)
+		return false;
+	if(!reader.ReadString(filekey) || (key != "" && key != filekey))
+		return false;
+
+	// parameters
+	ConfigSpaceState state;
+	std::vector<t_real> ranges, senses, sample_range, mono_range;
+	std::uint64_t kf_fixed = 1;
+	if(!reader.ReadArray(ranges) || ranges.size() != state.ranges.size())
+		return false;
+	if(!reader.ReadArray(senses) || senses.size() != state.senses.size())
+		return false;
+	if(!reader.Read(state.a6) || !reader.Read(kf_fixed))
+		return false;
+	if(!reader.ReadArray(sample_range) || sample_range.size() != 2)
+		return false;
+	if(!reader.ReadArray(mono_range) || mono_range.size() != 2)
+		return false;
+
+	std::copy(ranges.begin(), ranges.end(), state.ranges.begin());
+	std::copy(senses.begin(), senses.end(), state.senses.begin());
+	state.kf_fixed = (kf_fixed != 0);
+
+	// configuration space image
+	std::uint64_t img_w = 0, img_h = 0;
+	std::vector<std::uint8_t> pixels;
+	if(!reader.Read(img_w) || !reader.Read(img_h) || !reader.ReadArray(pixels))
+		return false;
+	if(pixels.size() != img_w * img_h)
+		return false;
+
+	// wall contours
+	auto read_contours = [&reader](std::vector<std::vector<t_contourvec>>& contours) -> bool
+	{
+		std::uint64_t num_contours = 0;
+		if(!reader.Read(num_contours))
+			return false;
+
+		contours.clear();
+		for(std::uint64_t contouridx=0; contouridx<num_contours; ++contouridx)
+		{
+			std::vector<std::int64_t> coords;
+			if(!reader.ReadArray(coords))
+				return false;
+
+			std::vector<t_contourvec> contour;
+			contour.reserve(coords.size() / 2);
+			for(std::size_t idx=0; idx+1<coords.size(); idx+=2)
+			{
+				contour.emplace_back(tl2::create<t_contourvec>({
+					static_cast<t_int>(coords[idx]),
+					static_cast<t_int>(coords[idx + 1]) }));
+			}
+
+			contours.emplace_back(std::move(contour));
+		}
+
+		return true;
+	};
+
+	std::vector<std::vector<t_contourvec>> wallcontours, fullwallcontours;
+	if(!read_contours(wallcontours) || !read_contours(fullwallcontours))
+		return false;
+
+	// line segments and groups
+	std::vector<t_real> line_coords, points;
+	std::vector<std::uint64_t> groups;
+	std::vector<std::uint8_t> inverted;
+	if(!reader.ReadArray(line_coords) || !reader.ReadArray(groups) ||
+		!reader.ReadArray(points) || !reader.ReadArray(inverted))
+		return false;
+	if(line_coords.size() % 4 != 0 || groups.size() % 2 != 0)
+		return false;
+
+	// reject corrupt files with line groups referring to non-existing line segments
+	const std::size_t num_lines = line_coords.size() / 4;
+	for(std::size_t idx=0; idx+1<groups.size(); idx+=2)
+	{
+		if(groups[idx] > groups[idx + 1] || groups[idx + 1] > num_lines)
+			return false;
+	}
+
+	// voronoi vertices and linear bisectors
+	std::vector<t_real> vert_coords, lin_coords;
+	std::vector<std::uint64_t> lin_indices;
+	if(!reader.ReadArray(vert_coords) || !reader.ReadArray(lin_coords) || !reader.ReadArray(lin_indices))
+		return false;
+	if(lin_coords.size() != lin_indices.size() * 2)
+		return false;
+
+	geo::VoronoiLinesResults<t_vec2, t_line, t_graph> voro_results;
+
+	auto& verts = voro_results.GetVoronoiVertices();
+	verts.reserve(vert_coords.size() / 2);
+	for(std::size_t idx=0; idx+1<vert_coords.size(); idx+=2)
+		verts.emplace_back(tl2::create<t_vec2>({ vert_coords[idx], vert_coords[idx + 1] }));
+
+	const std::size_t num_verts = verts.size();
+
+	auto get_index = [](std::uint64_t idx) -> std::optional<std::size_t>
+	{
+		if(idx == pathmesh_no_index)
+			return std::nullopt;
+		return idx;
+	};
+
+	// reject corrupt files referring to non-existing voronoi vertices
+	auto is_valid_index = [num_verts](std::uint64_t idx, bool allow_none) -> bool
+	{
+		if(idx == pathmesh_no_index)
+			return allow_none;
+		return idx < num_verts;
+	};
+
+	auto& lin_edges = voro_results.GetLinearEdgesVec();
+	lin_edges.reserve(lin_indices.size() / 2);
+	for(std::size_t idx=0; idx+1<lin_indices.size(); idx+=2)
+	{
+		if(!is_valid_index(lin_indices[idx], true) || !is_valid_index(lin_indices[idx + 1], true))
+			return false;
+
+		const t_real *coords = lin_coords.data() + idx*2;
+		t_line line = std::make_pair(
+			tl2::create<t_vec2>({ coords[0], coords[1] }),
+			tl2::create<t_vec2>({ coords[2], coords[3] }));
+
+		lin_edges.emplace_back(std::make_tuple(std::move(line),
+			get_index(lin_indices[idx]), get_index(lin_indices[idx + 1])));
+	}
+
+	// parabolic bisectors
+	std::uint64_t num_para_edges = 0;
+	if(!reader.Read(num_para_edges))
+		return false;
+
+	auto& para_edges = voro_results.GetParabolicEdgesVec();
+	for(std::uint64_t edgeidx=0; edgeidx<num_para_edges; ++edgeidx)
+	{
+		std::vector<std::uint64_t> indices;
+		std::vector<t_real> coords;
+		if(!reader.ReadArray(indices) || indices.size() != 2 || !reader.ReadArray(coords))
+			return false;
+		if(!is_valid_index(indices[0], false) || !is_valid_index(indices[1], false))
+			return false;
+
+		std::vector<t_vec2> edge_points;
+		edge_points.reserve(coords.size() / 2);
+		for(std::size_t idx=0; idx+1<coords.size(); idx+=2)
+			edge_points.emplace_back(tl2::create<t_vec2>({ coords[idx], coords[idx + 1] }));
+
+		para_edges.emplace_back(std::make_tuple(std::move(edge_points), indices[0], indices[1]));
+	}
+
+	// voronoi graph
+	std::uint64_t num_graph_verts = 0;
+	if(!reader.Read(num_graph_verts) || num_graph_verts != num_verts)
+		return false;
+
+	t_graph& graph = voro_results.GetVoronoiGraph();
+	for(std::uint64_t vertidx=0; vertidx<num_graph_verts; ++vertidx)
+	{
+		std::string ident;
+		if(!reader.ReadString(ident))
+			return false;
+		graph.AddVertex(ident);
+	}
+
+	std::vector<std::uint64_t> edge_indices;
+	std::vector<t_real> edge_weights;
+	if(!reader.ReadArray(edge_indices) || !reader.ReadArray(edge_weights))
+		return false;
+	if(edge_indices.size() != edge_weights.size() * 2)
+		return false;
+
+	for(std::size_t edgeidx=0; edgeidx<edge_weights.size(); ++edgeidx)
+	{
+		if(edge_indices[edgeidx*2] >= num_graph_verts || edge_indices[edgeidx*2 + 1] >= num_graph_verts)
+			return false;
+
+		graph.AddEdge(edge_indices[edgeidx*2], edge_indices[edgeidx*2 + 1],
+			edge_weights[edgeidx]);
+	}
+	geo::finalise_graph(graph);
+
+	voro_results.CreateEdgeMaps();
+	voro_results.CreateIndexTree();
+
+
+	// all data has been read successfully, set the members
+	m_sampleScatteringRange[0] = sample_range[0];
+	m_sampleScatteringRange[1] = sample_range[1];
+	m_monoScatteringRange[0] = mono_range[0];
+	m_monoScatteringRange[1] = mono_range[1];
+
+	m_img.Init(img_w, img_h);
+	for(std::size_t y=0; y<img_h; ++y)
+		for(std::size_t x=0; x<img_w; ++x)
+			m_img.SetPixel(x, y, pixels[y*img_w + x]);
+
+	m_wallcontours = std::move(wallcontours);
+	m_fullwallcontours = std::move(fullwallcontours);
+
+	m_lines.clear();
+	m_lines.reserve(line_coords.size() / 4);
+	for(std::size_t idx=0; idx+3<line_coords.size(); idx+=4)
+	{
+		m_lines.emplace_back(std::make_pair(
+			tl2::create<t_vec2>({ line_coords[idx], line_coords[idx + 1] }),
+			tl2::create<t_vec2>({ line_coords[idx + 2], line_coords[idx + 3] })));
+	}
+
+	m_linegroups.clear();
+	m_linegroups.reserve(groups.size() / 2);
+	for(std::size_t idx=0; idx+1<groups.size(); idx+=2)
+		m_linegroups.emplace_back(std::make_pair(groups[idx], groups[idx + 1]));
+
+	m_points_outside_regions.clear();
+	m_points_outside_regions.reserve(points.size() / 2);
+	for(std::size_t idx=0; idx+1<points.size(); idx+=2)
+		m_points_outside_regions.emplace_back(tl2::create<t_vec2>({ points[idx], points[idx + 1] }));
+
+	m_inverted_regions.assign(inverted.begin(), inverted.end());
+
+	m_voro_results = std::move(voro_results);
+	CalculateWallsIndexTree();
+
+	// the loaded mesh belongs to the current instrument and walls
+	if(m_instrspace)
+	{
+		state.instr_version = m_instrspace->GetInstrumentVersion();
+		state.walls = m_instrspace->GetWallsCollisionScene();
+	}
+	m_cfgspace_state = state;
+
+	return true;
+}
+
+
+/**
+ * get the cache file name corresponding to a key
+ */
+std::string PathsBuilder::GetPathMeshCacheFile(const std::string& key) const
+{
+	if(m_cachedir == "" || key == "")
+		return "";
+
+	return (std::filesystem::path(m_cachedir) / (key + PATHMESH_FILE_EXT)).string();
+}
+
+
+/**
+ * save the current path mesh in the cache directory
+ */
+bool PathsBuilder::SavePathMeshToCache(const std::string& key) const
+{
+	std::string filename = GetPathMeshCacheFile(key);
+	if(filename == "")
+		return false;
+
+	std::error_code err;
+	std::filesystem::create_directories(m_cachedir, err);
+	if(err)
+		return false;
+
+	return SavePathMesh(filename, key);
+}
+
+
+/**
+ * load a path mesh from the cache directory
+ */
+bool PathsBuilder::LoadPathMeshFromCache(const std::string& key)
+{
+	std::string filename = GetPathMeshCacheFile(key);
+	if(filename == "")
+		return false;
+
+	return LoadPathMesh(filename, key);
+}
+// ----------------------------------------------------------------------------
@@ -0,0 +1,384 @@
+/**
+ * simplification of instrument paths and time-parametrised trajectories along them
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+/*
+ * The trajectory is a trapezoidal velocity profile along the path, with both
+ * motors moving synchronously. On each segment the path velocity and acceleration
+ * are limited by the axis whose speed or acceleration limit is reached first.
+ * At a corner the motors don't need to stop: the controller rounds the corner
+ * with a maximum deviation from the waypoint (the "junction deviation" model),
+ * which is given by the wall distance at the corner that exceeds the minimum
+ * distance to keep. A forward and a backward pass then make sure that all
+ * velocity changes can be reached with the given accelerations.
+ */
+
+#include "PathsBuilder.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+
+
+// ----------------------------------------------------------------------------
+// paths builder -- trajectory part
+// ----------------------------------------------------------------------------
+/**
+ * check if the vertices idx1 and idx2 of a path can be connected directly,
+ * the direct segment has to keep the minimum distance to the walls, or at least
+ * the distance that the original path keeps between the two vertices
+ * @arg dists distances of the path vertices to the nearest walls
+ */
+bool PathsBuilder::IsPathShortcutClear(const std::vector<t_vec2>& path,
+	const std::vector<t_real>& dists, std::size_t idx1, std::size_t idx2, bool deg) const
+{
+	// the original path segment
+	if(idx2 == idx1 + 1)
+		return true;
+
+	// don't require a larger distance than the original path keeps
+	t_real min_dist = *std::min_element(dists.begin() + idx1, dists.begin() + idx2 + 1);
+	min_dist = std::min(min_dist, std::max(m_min_angular_dist_to_walls, t_real(0)));
+
+	return IsPathSegmentClear(path[idx1], path[idx2], min_dist, deg);
+}
+
+
+/**
+ * shortcut the vertices of a path: a vertex is connected directly
+ * to the farthest following vertex that can be reached without
+ * getting closer to the walls, see IsPathShortcutClear()
+ * @arg path path vertices in angular coordinates
+ */
+std::vector<t_vec2> PathsBuilder::ShortcutPath(const std::vector<t_vec2>& path, bool deg) const
+{
+	if(path.size() <= 2)
+		return path;
+
+	const std::size_t num_verts = path.size();
+	const std::vector<t_real> dists = GetDistancesToNearestWall(path, deg);
+
+	// can the vertices idx1 and idx2 be connected directly?
+	auto is_clear = [this, &path, &dists, deg](std::size_t idx1, std::size_t idx2) -> bool
+	{
+		return IsPathShortcutClear(path, dists, idx1, idx2, deg);
+	};
+
+	std::vector<t_vec2> shortcut_path;
+	shortcut_path.push_back(path[0]);
+
+	for(std::size_t idx=0; idx<num_verts-1;)
+	{
+		// farthest known clear and closest known blocked vertex
+		std::size_t idx_clear = idx + 1;
+		std::size_t idx_blocked = num_verts;
+
+		// search the farthest clear vertex with exponentially increasing steps ...
+		for(std::size_t step=2; ; step*=2)
+		{
+			std::size_t idx_next = std::min(idx + step, num_verts - 1);
+			if(idx_next <= idx_clear)
+				break;
+
+			if(!is_clear(idx, idx_next))
+			{
+				idx_blocked = idx_next;
+				break;
+			}
+
+			idx_clear = idx_next;
+		}
+
+		// ... and refine it by bisection
+		while(idx_blocked - idx_clear > 1)
+		{
+			std::size_t idx_mid = (idx_clear + idx_blocked) / 2;
+
+			if(is_clear(idx, idx_mid))
+				idx_clear = idx_mid;
+			else
+				idx_blocked = idx_mid;
+		}
+
+		shortcut_path.push_back(path[idx_clear]);
+		idx = idx_clear;
+	}
+
+	return shortcut_path;
+}
+
+
+/**
+ * simplify a path using a variant of the douglas-peucker algorithm:
+ * a vertex may be removed if its distance to the simplified segment is within
+ * its clearance budget, i.e. its distance to the walls exceeding the minimum
+ * distance to keep, and if the simplified segment doesn't get closer to the walls
+ * @arg path path vertices in angular coordinates
+ */
+std::vector<t_vec2> PathsBuilder::SimplifyPath(const std::vector<t_vec2>& path, bool deg) const
+{
+	if(path.size() <= 2)
+		return path;
+
+	const std::size_t num_verts = path.size();
+	const std::vector<t_real> dists = GetDistancesToNearestWall(path, deg);
+	const t_real to_rad = deg ? tl2::pi<t_real> / t_real(180) : t_real(1);
+
+	// clearance budgets of the vertices
+	std::vector<t_real> budgets;
+	budgets.reserve(num_verts);
+	for(t_real dist : dists)
+		budgets.push_back(std::max(dist - std::max(m_min_angular_dist_to_walls, t_real(0)), t_real(0)));
+
+	std::vector<bool> keep(num_verts, false);
+	keep[0] = keep[num_verts - 1] = true;
+
+	// path ranges that still need to be simplified
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	ranges.emplace_back(std::make_pair(0, num_verts - 1));
+
+	while(ranges.size())
+	{
+		auto [idx1, idx2] = *ranges.rbegin();
+		ranges.pop_back();
+
+		if(idx2 <= idx1 + 1)
+			continue;
+
+		const t_vec2& vert1 = path[idx1];
+		const t_vec2 dir = path[idx2] - vert1;
+		const t_real len_sq = tl2::inner<t_vec2>(dir, dir);
+
+		// find the vertex that exceeds its clearance budget the most
+		std::size_t idx_max = idx1 + 1;
+		t_real max_excess = -std::numeric_limits<t_real>::max();
+
+		for(std::size_t idx=idx1+1; idx<idx2; ++idx)
+		{
+			// offset from the vertex to the closest point on the segment
+			t_vec2 offs = path[idx] - vert1;
+			if(len_sq > 0.)
+			{
+				t_real param = std::clamp<t_real>(tl2::inner<t_vec2>(offs, dir) / len_sq, 0., 1.);
+				offs = offs - dir*param;
+			}
+
+			// the offset's length in the metric of the wall distances
+			t_real excess = GetPathLength(offs * to_rad) - budgets[idx];
+			if(excess > max_excess)
+			{
+				max_excess = excess;
+				idx_max = idx;
+			}
+		}
+
+		// all vertices are within their budgets and the direct segment keeps the distance to the walls
+		if(max_excess <= 0. && IsPathShortcutClear(path, dists, idx1, idx2, deg))
+			continue;
+
+		// otherwise keep the vertex and simplify both sides
+		keep[idx_max] = true;
+		ranges.emplace_back(std::make_pair(idx1, idx_max));
+		ranges.emplace_back(std::make_pair(idx_max, idx2));
+	}
+
+	std::vector<t_vec2> simplified_path;
+	for(std::size_t idx=0; idx<num_verts; ++idx)
+	{
+		if(keep[idx])
+			simplified_path.push_back(path[idx]);
+	}
+
+	return simplified_path;
+}
+
+
+/**
+ * calculate a velocity- and acceleration-limited trajectory along the path vertices
+ * @arg path path vertices in angular coordinates
+ * @arg shortcut shortcut the path before calculating the trajectory
+ */
+InstrumentTrajectory PathsBuilder::GetTrajectory(
+	const std::vector<t_vec2>& path, bool shortcut, bool deg) const
+{
+	InstrumentTrajectory traj{};
+	traj.ok = false;
+
+	if(path.size() == 0 || !m_instrspace)
+		return traj;
+
+	// conversion factor from the path coordinates to radians
+	const t_real to_rad = deg ? tl2::pi<t_real> / t_real(180) : t_real(1);
+
+	// remove zero-length segments
+	std::vector<t_vec2> verts;
+	verts.reserve(path.size());
+	for(const t_vec2& vert : shortcut ? ShortcutPath(path, deg) : path)
+	{
+		if(verts.size() && tl2::norm<t_vec2>(vert - *verts.rbegin()) * to_rad <= m_eps_angular)
+			continue;
+		verts.push_back(vert);
+	}
+
+	const std::size_t num_verts = verts.size();
+	const std::size_t num_segs = num_verts - 1;
+	const t_real infinity = std::numeric_limits<t_real>::infinity();
+
+	// motor speeds and accelerations
+	t_vec2 speeds = GetMotorSpeeds();
+	t_vec2 accels = tl2::create<t_vec2>({infinity, infinity});
+	for(std::size_t axis=0; axis<2; ++axis)
+	{
+		speeds[axis] = std::abs(speeds[axis]);
+		if(m_motor_accel_time > 0.)
+			accels[axis] = speeds[axis] / m_motor_accel_time;
+	}
+
+	// lengths (in rad), directions and velocity and acceleration limits of the segments
+	std::vector<t_real> seg_lens(num_segs);
+	std::vector<t_vec2> seg_dirs(num_segs);
+	std::vector<t_real> seg_max_vels(num_segs, infinity);
+	std::vector<t_real> seg_accels(num_segs, infinity);
+
+	for(std::size_t seg=0; seg<num_segs; ++seg)
+	{
+		t_vec2 delta = (verts[seg + 1] - verts[seg]) * to_rad;
+		seg_lens[seg] = tl2::norm<t_vec2>(delta);
+		seg_dirs[seg] = delta / seg_lens[seg];
+
+		// the axis that reaches its limit first determines the limit of the path
+		for(std::size_t axis=0; axis<2; ++axis)
+		{
+			t_real dir = std::abs(seg_dirs[seg][axis]);
+			if(dir <= m_eps)
+				continue;
+
+			seg_max_vels[seg] = std::min(seg_max_vels[seg], speeds[axis] / dir);
+			seg_accels[seg] = std::min(seg_accels[seg], accels[axis] / dir);
+		}
+
+		// a motor that can't move can't follow the path
+		if(seg_max_vels[seg] <= 0. || seg_accels[seg] <= 0.)
+			return traj;
+	}
+
+	// the wall distances are given in the configuration space metric,
+	// use the slower motor to convert them into angular distances
+	t_real metric_to_rad = 1.;
+	if(m_use_motor_speeds)
+		metric_to_rad = std::min(speeds[0], speeds[1]);
+
+	// maximum velocities at the waypoints, the motors start and stop at rest
+	std::vector<t_real> vels(num_verts, 0.);
+	for(std::size_t vert=1; vert+1<num_verts; ++vert)
+	{
+		const t_vec2& dir_in = seg_dirs[vert - 1];
+		const t_vec2& dir_out = seg_dirs[vert];
+
+		t_real max_vel = std::min(seg_max_vels[vert - 1], seg_max_vels[vert]);
+
+		// half of the angle between the reversed incoming and the outgoing directions
+		t_real cos_angle = -tl2::inner<t_vec2>(dir_in, dir_out);
+		t_real sin_half_angle = std::sqrt(std::max(t_real(0.5) * (t_real(1) - cos_angle), t_real(0)));
+
+		if(sin_half_angle < t_real(1) - m_eps)
+		{
+			// deviation from the waypoint that keeps the minimum distance to the walls
+			t_real wall_dist = GetDistToNearestWall(AngleToPixel(verts[vert], deg, false));
+			t_real deviation = std::max(wall_dist - std::max(m_min_angular_dist_to_walls, t_real(0)), t_real(0));
+			deviation *= metric_to_rad;
+
+			// maximum velocity to round the corner within the deviation
+			t_real accel = std::min(seg_accels[vert - 1], seg_accels[vert]);
+			t_real corner_vel = std::sqrt(accel * deviation * sin_half_angle / (t_real(1) - sin_half_angle));
+			if(!std::isnan(corner_vel))
+				max_vel = std::min(max_vel, corner_vel);
+			else
+				max_vel = 0.;
+		}
+
+		vels[vert] = max_vel;
+	}
+
+	// limit the velocities to what can be reached by accelerating ...
+	for(std::size_t seg=0; seg<num_segs; ++seg)
+	{
+		vels[seg + 1] = std::min(vels[seg + 1],
+			std::sqrt(vels[seg]*vels[seg] + t_real(2)*seg_accels[seg]*seg_lens[seg]));
+	}
+
+	// ... and by decelerating
+	for(std::size_t seg=num_segs; seg>0; --seg)
+	{
+		vels[seg - 1] = std::min(vels[seg - 1],
+			std::sqrt(vels[seg]*vels[seg] + t_real(2)*seg_accels[seg - 1]*seg_lens[seg - 1]));
+	}
+
+	// time needed for a segment with a trapezoidal velocity profile
+	auto get_seg_time = [](t_real len, t_real vel_start, t_real vel_end,
+		t_real max_vel, t_real accel) -> t_real
+	{
+		// instantaneous acceleration
+		if(std::isinf(accel))
+			return len / max_vel;
+
+		// highest velocity that can be reached on the segment
+		t_real peak_vel = std::sqrt(t_real(0.5) *
+			(t_real(2)*accel*len + vel_start*vel_start + vel_end*vel_end));
+
+		// triangular profile
+		if(peak_vel <= max_vel)
+			return (t_real(2)*peak_vel - vel_start - vel_end) / accel;
+
+		// trapezoidal profile
+		t_real len_accel = (max_vel*max_vel - vel_start*vel_start) / (t_real(2)*accel);
+		t_real len_decel = (max_vel*max_vel - vel_end*vel_end) / (t_real(2)*accel);
+
+		return (t_real(2)*max_vel - vel_start - vel_end) / accel
+			+ (len - len_accel - len_decel) / max_vel;
+	};
+
+	traj.vertices = std::move(verts);
+	traj.times.reserve(num_verts);
+	traj.velocities.reserve(num_verts);
+
+	t_real time = 0.;
+	for(std::size_t vert=0; vert<num_verts; ++vert)
+	{
+		if(vert > 0)
+		{
+			time += get_seg_time(seg_lens[vert - 1], vels[vert - 1], vels[vert],
+				seg_max_vels[vert - 1], seg_accels[vert - 1]);
+		}
+
+		traj.times.push_back(time);
+		traj.velocities.push_back(vels[vert] / to_rad);
+	}
+
+	traj.total_time = time;
+	traj.ok = true;
+	return traj;
+}
+// ----------------------------------------------------------------------------
@@ -0,0 +1,309 @@
+/**
+ * persistent thread pool with work stealing
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <algorithm>
+
+
+// pool of the current worker thread
+static thread_local const ThreadPool *g_worker_pool = nullptr;
+
+
+/**
+ * constructor, starts the worker threads
+ */
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+	Start(num_threads);
+}
+
+
+/**
+ * destructor, finishes all queued work and joins the worker threads
+ */
+ThreadPool::~ThreadPool()
+{
+	Stop();
+}
+
+
+/**
+ * get the number of worker threads
+ */
+unsigned int ThreadPool::GetNumThreads() const
+{
+	std::shared_lock<std::shared_mutex> lock_workers{m_mtx_workers};
+	return static_cast<unsigned int>(m_workers.size());
+}
+
+
+/**
+ * change the number of worker threads
+ */
+void ThreadPool::SetNumThreads(unsigned int num_threads)
+{
+	if(num_threads == 0)
+		num_threads = std::max<unsigned int>(1, std::thread::hardware_concurrency());
+
+	// wait for running jobs to finish
+	std::unique_lock<std::shared_mutex> lock_workers{m_mtx_workers};
+	if(num_threads == m_workers.size())
+		return;
+
+	Stop();
+	Start(num_threads);
+}
+
+
+/**
+ * create the worker threads
+ */
+void ThreadPool::Start(unsigned int num_threads)
+{
+	if(num_threads == 0)
+		num_threads = std::max<unsigned int>(1, std::thread::hardware_concurrency());
+
+	m_stop = false;
+	m_next_worker = 0;
+
+	m_workers.clear();
+	m_workers.reserve(num_threads);
+	for(unsigned int idx=0; idx<num_threads; ++idx)
+		m_workers.emplace_back(std::make_unique<Worker>());
+
+	for(std::size_t idx=0; idx<m_workers.size(); ++idx)
+		m_workers[idx]->thread = std::thread([this, idx]() { WorkerLoop(idx); });
+}
+
+
+/**
+ * let the worker threads finish the queued tiles and join them
+ */
+void ThreadPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock{m_mtx};
+		m_stop = true;
+	}
+	m_work_available.notify_all();
+
+	for(auto& worker : m_workers)
+	{
+		if(worker->thread.joinable())
+			worker->thread.join();
+	}
+
+	m_workers.clear();
+}
+
+
+/**
+ * get the next tile for the given worker, first looking at its own queue,
+ * then trying to steal from the back of the other workers' queues
+ */
+std::optional<ThreadPool::Tile> ThreadPool::PopTile(std::size_t worker)
+{
+	const std::size_t num_workers = m_workers.size();
+
+	for(std::size_t offs=0; offs<num_workers; ++offs)
+	{
+		std::size_t idx = (worker + offs) % num_workers;
+		Worker& queue = *m_workers[idx];
+
+		std::lock_guard<std::mutex> lock{queue.mtx};
+		if(queue.tiles.empty())
+			continue;
+
+		Tile tile;
+		if(idx == worker)
+		{
+			// own queue
+			tile = std::move(queue.tiles.front());
+			queue.tiles.pop_front();
+		}
+		else
+		{
+			// steal from other queue
+			tile = std::move(queue.tiles.back());
+			queue.tiles.pop_back();
+		}
+
+		--m_num_pending;
+		return tile;
+	}
+
+	return std::nullopt;
+}
+
+
+/**
+ * process a tile and signal the job's completion after its last tile
+ */
+void ThreadPool::RunTile(Tile& tile, std::size_t worker)
+{
+	Job& job = *tile.job;
+
+	// tiles of cancelled jobs are only drained
+	if(!job.cancelled)
+	{
+		try
+		{
+			job.func(tile.begin, tile.end, worker);
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> lock{job.mtx};
+			if(!job.exception)
+				job.exception = std::current_exception();
+			job.cancelled = true;
+		}
+	}
+
+	if(--job.tiles_remaining == 0)
+	{
+		std::lock_guard<std::mutex> lock{job.mtx};
+		job.finished.notify_all();
+	}
+}
+
+
+/**
+ * main loop of the worker threads
+ */
+void ThreadPool::WorkerLoop(std::size_t worker)
+{
+	g_worker_pool = this;
+
+	while(true)
+	{
+		if(std::optional<Tile> tile = PopTile(worker); tile)
+		{
+			RunTile(*tile, worker);
+			continue;
+		}
+
+		// wait for new work
+		std::unique_lock<std::mutex> lock{m_mtx};
+		m_work_available.wait(lock, [this]() -> bool
+		{
+			return m_stop || m_num_pending > 0;
+		});
+
+		if(m_stop && m_num_pending == 0)
+			break;
+	}
+}
+
+
+/**
+ * split the item range [0, num_items) into tiles and process them on the worker threads,
+ * the function blocks until all tiles are finished or the job has been cancelled;
+ * the optional prepare function gets the number of workers, e.g. to size per-worker contexts
+ * @returns false if the job was cancelled using the progress function
+ * @note must not be called from within a worker thread, see IsWorkerThread()
+ */
+bool ThreadPool::ParallelFor(std::size_t num_items, std::size_t tile_size,
+	const t_func& func, const t_progress& progress, const t_prepare& prepare)
+{
+	if(num_items == 0)
+		return true;
+
+	std::shared_lock<std::shared_mutex> lock_workers{m_mtx_workers};
+	const std::size_t num_workers = m_workers.size();
+
+	// the number of workers can't change anymore until the job is finished
+	if(prepare)
+		prepare(num_workers);
+
+	// automatically choose the tile size to get several tiles per thread
+	if(tile_size == 0)
+		tile_size = std::max<std::size_t>(1, num_items / (num_workers * 16));
+	const std::size_t num_tiles = (num_items + tile_size - 1) / tile_size;
+
+	auto job = std::make_shared<Job>();
+	job->func = func;
+	job->tiles_remaining = num_tiles;
+
+	// distribute contiguous blocks of tiles to the worker queues
+	{
+		std::lock_guard<std::mutex> lock{m_mtx};
+		m_num_pending += num_tiles;
+
+		std::size_t first_worker = m_next_worker;
+		m_next_worker = (m_next_worker + 1) % num_workers;
+
+		for(std::size_t tileidx=0; tileidx<num_tiles; ++tileidx)
+		{
+			std::size_t idx = (first_worker + tileidx*num_workers/num_tiles) % num_workers;
+			Worker& queue = *m_workers[idx];
+
+			std::lock_guard<std::mutex> lock_queue{queue.mtx};
+			queue.tiles.emplace_back(Tile
+			{
+				.job = job,
+				.begin = tileidx * tile_size,
+				.end = std::min((tileidx + 1) * tile_size, num_items),
+			});
+		}
+	}
+	m_work_available.notify_all();
+
+
+	// wait for the job to finish, reporting the progress
+	std::unique_lock<std::mutex> lock{job->mtx};
+	while(job->tiles_remaining > 0)
+	{
+		job->finished.wait_for(lock, std::chrono::milliseconds(50));
+
+		if(progress && job->tiles_remaining > 0 && !job->cancelled)
+		{
+			t_real done = t_real(num_tiles - job->tiles_remaining) / t_real(num_tiles);
+
+			lock.unlock();
+			bool cont = progress(done);
+			lock.lock();
+
+			if(!cont)
+				job->cancelled = true;
+		}
+	}
+
+	if(job->exception)
+		std::rethrow_exception(job->exception);
+
+	return !job->cancelled;
+}
+
+
+/**
+ * is the calling thread one of this pool's workers?
+ * nested ParallelFor() calls from the workers have to run sequentially instead
+ */
+bool ThreadPool::IsWorkerThread() const
+{
+	return g_worker_pool == this;
+}
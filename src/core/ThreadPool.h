@@ -0,0 +1,226 @@
+/**
+ * persistent thread pool with work stealing
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#ifndef __TASPATHS_THREADPOOL_H__
+#define __TASPATHS_THREADPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <optional>
+
+#include "types.h"
+
+
+// ----------------------------------------------------------------------------
+// thread pool
+// ----------------------------------------------------------------------------
+class ThreadPool
+{
+public:
+	// function working on the item range [begin, end) in the given worker thread
+	using t_func = std::function<void(std::size_t begin, std::size_t end, std::size_t worker)>;
+
+	// progress function, returns false to request cancellation
+	using t_progress = std::function<bool(t_real progress)>;
+
+	// function called with the number of workers before a job is started
+	using t_prepare = std::function<void(std::size_t num_workers)>;
+
+
+public:
+	ThreadPool(unsigned int num_threads = 4);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	const ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int GetNumThreads() const;
+	void SetNumThreads(unsigned int num_threads);
+
+	bool ParallelFor(std::size_t num_items, std::size_t tile_size,
+		const t_func& func, const t_progress& progress = nullptr,
+		const t_prepare& prepare = nullptr);
+
+	// is the calling thread one of this pool's workers?
+	bool IsWorkerThread() const;
+
+
+protected:
+	void Start(unsigned int num_threads);
+	void Stop();
+
+	void WorkerLoop(std::size_t worker);
+
+
+private:
+	// a job consisting of several tiles
+	struct Job
+	{
+		t_func func{};
+
+		std::atomic<std::size_t> tiles_remaining{0};
+		std::atomic<bool> cancelled{false};
+
+		std::exception_ptr exception{};
+		std::mutex mtx{};
+		std::condition_variable finished{};
+	};
+
+	// a range of items of a job
+	struct Tile
+	{
+		std::shared_ptr<Job> job{};
+		std::size_t begin{}, end{};
+	};
+
+	// tile queue of each worker thread
+	struct Worker
+	{
+		std::deque<Tile> tiles{};
+		std::mutex mtx{};
+		std::thread thread{};
+	};
+
+	std::optional<Tile> PopTile(std::size_t worker);
+	void RunTile(Tile& tile, std::size_t worker);
+
+
+private:
+	std::vector<std::unique_ptr<Worker>> m_workers{};
+
+	// number of queued tiles over all workers
+	std::atomic<std::size_t> m_num_pending{0};
+
+	// worker queue to put the next job's first tile into
+	std::size_t m_next_worker{0};
+
+	bool m_stop{false};
+	std::mutex m_mtx{};
+	std::condition_variable m_work_available{};
+
+	// protects the worker list against changes while jobs are running
+	mutable std::shared_mutex m_mtx_workers{};
+};
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// per-worker contexts
+// ----------------------------------------------------------------------------
+/**
+ * per-worker copies of an object, each worker thread clones the original
+ * only once on first use and afterwards works on its own copy
+ */
+template<class T>
+class WorkerContexts
+{
+public:
+	// optional function to prepare a fresh copy
+	using t_init = std::function<void(T&)>;
+
+
+public:
+	WorkerContexts(const T& orig, std::size_t num_workers, const t_init& init = nullptr)
+		: m_orig{orig}, m_contexts(num_workers), m_init{init}
+	{}
+
+	WorkerContexts(const T& orig, const ThreadPool& pool, const t_init& init = nullptr)
+		: WorkerContexts(orig, pool.GetNumThreads(), init)
+	{}
+
+	WorkerContexts(const WorkerContexts&) = delete;
+	const WorkerContexts& operator=(const WorkerContexts&) = delete;
+
+
+	/**
+	 * provide a context slot for each worker, the number of workers can change
+	 * between the creation of the contexts and the start of a job, so this is
+	 * called by ThreadPool::ParallelFor() before the workers access the contexts
+	 */
+	void Resize(std::size_t num_workers)
+	{
+		if(num_workers > m_contexts.size())
+			m_contexts.resize(num_workers);
+	}
+
+
+	/**
+	 * get the function to pass to ThreadPool::ParallelFor() for resizing the contexts
+	 */
+	ThreadPool::t_prepare GetPrepareFunc()
+	{
+		return [this](std::size_t num_workers) { Resize(num_workers); };
+	}
+
+
+	/**
+	 * get the context of the given worker, cloning the original on first use;
+	 * every slot is only accessed by its own worker, so no locking is needed
+	 */
+	T& Get(std::size_t worker)
+	{
+		std::unique_ptr<T>& ctx = m_contexts[worker];
+
+		if(!ctx)
+		{
+			ctx = std::make_unique<T>(m_orig);
+			if(m_init)
+				m_init(*ctx);
+		}
+
+		return *ctx;
+	}
+
+
+	/**
+	 * number of copies created so far
+	 */
+	std::size_t GetNumClones() const
+	{
+		std::size_t num = 0;
+		for(const auto& ctx : m_contexts)
+			if(ctx)
+				++num;
+		return num;
+	}
+
+
+private:
+	const T& m_orig;
+	std::vector<std::unique_ptr<T>> m_contexts{};
+	t_init m_init{};
+};
+// ----------------------------------------------------------------------------
+
+
+#endif
@@ -122,6 +122,7 @@ public:
 
 template<class T> using t_arr2 = t_arr<T, 2>;
 template<class T> using t_arr4 = t_arr<T, 4>;
+template<class T> using t_arr16 = t_arr<T, 16>;
 
 
 using t_real = double;
@@ -136,6 +137,8 @@ using t_mat = tl2::mat<t_real, std::vector>;
 using t_vec2 = tl2::vec<t_real, t_arr2>;
 using t_vec2_int = tl2::vec<t_int, t_arr2>;
 using t_mat22 = tl2::mat<t_real, t_arr4>;
+using t_vec4 = tl2::vec<t_real, t_arr4>;
+using t_mat44 = tl2::mat<t_real, t_arr16>;
 
 
 // type indicating the state of an ongoing calculation
@@ -147,6 +150,7 @@ enum class CalculationState
 	RUNNING,
 
 	FAILED,
+	STEP_FAILED,
 
 	STEP_SUCCEEDED,
 	SUCCEEDED,
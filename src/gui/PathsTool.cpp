@@ -33,6 +33,8 @@
 #include <QtWidgets/QFileDialog>
 #include <QtGui/QDesktopServices>
 
+#include <sstream>
+
 #include <boost/predef.h>
 #include <boost/scope_exit.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -445,10 +447,14 @@ PathsTool::PathsTool(QWidget* pParent) : QMainWindow{pParent}
 	QAction *acExportRaw = new QAction("To Raw...", menuExportPath);
 	QAction *acExportNomad = new QAction("To Nomad...", menuExportPath);
 	QAction *acExportNicos = new QAction("To Nicos...", menuExportPath);
+	QAction *acExportBinary = new QAction("To Binary...", menuExportPath);
+	QAction *acExportJsonLines = new QAction("To JSON Lines...", menuExportPath);
 
 	menuExportPath->addAction(acExportRaw);
 	menuExportPath->addAction(acExportNomad);
 	menuExportPath->addAction(acExportNicos);
+	menuExportPath->addAction(acExportBinary);
+	menuExportPath->addAction(acExportJsonLines);
 
 	// recent files menu
 	m_menuOpenRecent = new QMenu("Open Recent", menuFile);
@@ -511,6 +517,16 @@ PathsTool::PathsTool(QWidget* pParent) : QMainWindow{pParent}
 		ExportPath(PathsExporterFormat::NICOS);
 	});
 
+	connect(acExportBinary, &QAction::triggered, [this]() -> void
+	{
+		ExportPath(PathsExporterFormat::BINARY);
+	});
+
+	connect(acExportJsonLines, &QAction::triggered, [this]() -> void
+	{
+		ExportPath(PathsExporterFormat::JSONL);
+	});
+
 
 	menuFile->addAction(actionNew);
 	menuFile->addSeparator();
@@ -652,6 +668,7 @@ PathsTool::PathsTool(QWidget* pParent) : QMainWindow{pParent}
 			this->m_dlgXtalConfigSpace = std::make_shared<XtalConfigSpaceDlg>(this, &m_sett);
 			this->m_dlgXtalConfigSpace->SetInstrumentSpace(&this->m_instrspace);
 			this->m_dlgXtalConfigSpace->SetTasCalculator(&this->m_tascalc);
+			this->m_dlgXtalConfigSpace->SetThreadPool(this->m_threadpool);
 
 			using t_gotocoords =
 				void (PathsTool::*)(t_real, t_real, t_real, t_real, t_real);
@@ -1403,6 +1420,12 @@ bool PathsTool::ExportPath(PathsExporterFormat fmt)
 		case PathsExporterFormat::NICOS:
 			exporter = std::make_shared<PathsExporterNicos>(files[0].toStdString());
 			break;
+		case PathsExporterFormat::BINARY:
+			exporter = std::make_shared<PathsExporterBinary>(files[0].toStdString());
+			break;
+		case PathsExporterFormat::JSONL:
+			exporter = std::make_shared<PathsExporterJsonLines>(files[0].toStdString());
+			break;
 	}
 
 	if(!exporter)
@@ -1411,7 +1434,11 @@ bool PathsTool::ExportPath(PathsExporterFormat fmt)
 		return false;
 	}
 
-	if(!m_pathsbuilder.AcceptExporter(exporter.get(), m_pathvertices, true))
+	// export using the path mesh snapshot that also answers the path queries
+	PathsBuilder::t_pathmesh pathmesh = m_pathsbuilder.GetPathMeshSnapshot();
+	const PathsBuilder *builder = pathmesh ? pathmesh.get() : &m_pathsbuilder;
+
+	if(!builder->AcceptExporter(exporter.get(), m_pathvertices, true))
 	{
 		QMessageBox::critical(this, "Error", "Path could not be exported.");
 		return false;
@@ -1758,6 +1785,12 @@ void PathsTool::SetCurrentFile(const QString &file)
 void PathsTool::ValidatePathMesh(bool valid)
 {
 	m_instrstatus.pathmeshvalid = valid;
+
+	// also withdraw an invalid path mesh from the path queries,
+	// e.g. the ones of the configuration space dialog
+	if(!valid)
+		m_pathsbuilder.ResetPathMeshSnapshot();
+
 	emit PathMeshValid(m_instrstatus.pathmeshvalid);
 
 	if(m_renderer)
@@ -2235,6 +2268,10 @@ void PathsTool::InitSettings()
 	m_instrspace.SetEpsilon(g_eps);
 	m_instrspace.SetPolyIntersectionMethod(g_poly_intersection_method);
 
+	if(!m_threadpool)
+		m_threadpool = std::make_shared<ThreadPool>(g_maxnum_threads);
+	m_pathsbuilder.SetThreadPool(m_threadpool);
+
 	m_pathsbuilder.SetMaxNumThreads(g_maxnum_threads);
 	m_pathsbuilder.SetEpsilon(g_eps);
 	m_pathsbuilder.SetAngularEpsilon(g_eps_angular);
@@ -2244,10 +2281,43 @@ void PathsTool::InitSettings()
 	m_pathsbuilder.SetMaxDirectPathRadius(g_directpath_search_radius);
 	m_pathsbuilder.SetNumClosestVoronoiVertices(g_num_closest_voronoi_vertices);
 	m_pathsbuilder.SetVerifyPath(g_verifypath != 0);
+	m_pathsbuilder.SetVerifyPathGeometryStep(g_verifypath_geo_step);
+	switch(g_pathsearch)
+	{
+		case 0:
+			m_pathsbuilder.SetPathSearch(PathSearch::DIJKSTRA);
+			break;
+		default:
+		case 1:
+			m_pathsbuilder.SetPathSearch(PathSearch::ASTAR);
+			break;
+		case 2:
+			m_pathsbuilder.SetPathSearch(PathSearch::BIDIRECTIONAL);
+			break;
+	}
 	m_pathsbuilder.SetMinDistToWalls(g_min_dist_to_walls);
 	m_pathsbuilder.SetRemoveBisectorsBelowMinWallDist(g_remove_bisectors_below_min_wall_dist != 0);
+	switch(g_cfgspace_sampling)
+	{
+		default:
+		case 0:
+			m_pathsbuilder.SetConfigSpaceSampling(ConfigSpaceSampling::FULL);
+			break;
+		case 1:
+			m_pathsbuilder.SetConfigSpaceSampling(ConfigSpaceSampling::ADAPTIVE);
+			break;
+		case 2:
+			m_pathsbuilder.SetConfigSpaceSampling(ConfigSpaceSampling::BOUNDARY);
+			break;
+	}
+	m_pathsbuilder.SetConfigSpaceCellSize(g_cfgspace_cellsize);
+	m_pathsbuilder.SetCacheDirectory(g_use_pathmesh_cache ? g_cachepath : "");
 	//m_pathsbuilder.SetUseRegionFunction(g_use_region_function != 0);
 
+	// the path queries use a snapshot of the path mesh, which also holds the options
+	if(m_instrstatus.pathmeshvalid)
+		m_pathsbuilder.PublishPathMeshSnapshot();
+
 	QMainWindow::DockOptions dockoptions{};
 	if(g_tabbed_docks)
 		dockoptions |= QMainWindow::AllowTabbedDocks | QMainWindow::VerticalTabs;
@@ -2559,10 +2629,10 @@ void PathsTool::ExternalPathAvailable(const InstrumentPath& path)
 		m_pathvertices.clear();
 		SetTmpStatus("Invalid path.");
 	}
-	else
+	else if(PathsBuilder::t_pathmesh pathmesh = m_pathsbuilder.GetPathMeshSnapshot(); pathmesh)
 	{
 		// get the vertices on the path
-		m_pathvertices = m_pathsbuilder.GetPathVertices(path, true, false);
+		m_pathvertices = pathmesh->GetPathVertices(path, true, false);
 		InterpolatePath(m_pathvertices);
 		ValidatePath(m_pathvertices.size() != 0);
 
@@ -2574,7 +2644,7 @@ void PathsTool::ExternalPathAvailable(const InstrumentPath& path)
 			ostrMsg << "Path calculated";
 			if(g_verifypath)
 			{
-				auto distances = m_pathsbuilder.GetDistancesToNearestWall(m_pathvertices, false);
+				auto distances = pathmesh->GetDistancesToNearestWall(m_pathvertices, false);
 				t_real min_dist = *std::min_element(distances.begin(), distances.end());
 				min_dist = min_dist / tl2::pi<t_real>*t_real(180);
 
@@ -2668,8 +2738,46 @@ bool PathsTool::CalculatePathMesh()
 
 		CHECK_STOP
 
+		// contour backend
+		ContourBackend contour_backend{ContourBackend::INTERNAL};
+#ifdef USE_OCV
+		if(g_contour_backend == 1)
+			contour_backend = ContourBackend::OCV;
+#endif
+
+		// voronoi backend
+		VoronoiBackend voro_backend{VoronoiBackend::BOOST};
+		if(g_voronoi_backend == 1)
+			voro_backend = VoronoiBackend::CGAL;
+
+		// look for an already calculated path mesh in the cache
+		std::ostringstream ostrWorkflow;
+		ostrWorkflow << "contour_backend=" << static_cast<int>(contour_backend)
+			<< ";voronoi_backend=" << static_cast<int>(voro_backend)
+			<< ";region_function=" << g_use_region_function;
+		const std::string cache_key = m_pathsbuilder.GetPathMeshCacheKey(
+			g_a2_delta, g_a4_delta, starta2, enda2, starta4, enda4,
+			ostrWorkflow.str());
+
+		SetTmpStatus("Looking for cached path mesh.", 0);
+		if(m_pathsbuilder.LoadPathMeshFromCache(cache_key))
+		{
+			m_pathsbuilder.FinishPathMeshWorkflow(true);
+			ValidatePathMesh(true);
+
+			SetTmpStatus("Path mesh loaded from cache.");
+
+			bool ok = true;
+			if(m_autocalcpath)
+				ok = CalculatePath();
+			return ok;
+		}
+
+		CHECK_STOP
+
+		// only re-calculate the regions affected by changed walls if possible
 		SetTmpStatus("Calculating configuration space.", 0);
-		if(!m_pathsbuilder.CalculateConfigSpace(
+		if(!m_pathsbuilder.UpdateConfigSpace(
 			g_a2_delta, g_a4_delta,
 			starta2, enda2, starta4, enda4))
 		{
@@ -2690,13 +2798,6 @@ bool PathsTool::CalculatePathMesh()
 
 		CHECK_STOP
 
-		// contour backend
-		ContourBackend contour_backend{ContourBackend::INTERNAL};
-#ifdef USE_OCV
-		if(g_contour_backend == 1)
-			contour_backend = ContourBackend::OCV;
-#endif
-
 		SetTmpStatus("Calculating obstacle contour lines.", 0);
 		if(!m_pathsbuilder.CalculateWallContours(true, false, contour_backend))
 		{
@@ -2718,12 +2819,6 @@ bool PathsTool::CalculatePathMesh()
 		CHECK_STOP
 
 		SetTmpStatus("Calculating Voronoi regions.", 0);
-
-		// voronoi backend
-		VoronoiBackend voro_backend{VoronoiBackend::BOOST};
-		if(g_voronoi_backend == 1)
-			voro_backend = VoronoiBackend::CGAL;
-
 		if(!m_pathsbuilder.CalculateVoronoi(false, voro_backend, g_use_region_function!=0))
 		{
 			m_pathsbuilder.FinishPathMeshWorkflow(false);
@@ -2733,9 +2828,14 @@ bool PathsTool::CalculatePathMesh()
 
 		CHECK_STOP
 
-		// validate the new path mesh
-		ValidatePathMesh(true);
+		// publish and validate the new path mesh
 		m_pathsbuilder.FinishPathMeshWorkflow(true);
+		ValidatePathMesh(true);
+
+		// store the new path mesh in the cache
+		if(m_pathsbuilder.GetCacheDirectory() != "" &&
+			!m_pathsbuilder.SavePathMeshToCache(cache_key))
+			std::cerr << "Warning: Could not write path mesh to cache." << std::endl;
 
 		SetTmpStatus("Path mesh calculated.");
 
@@ -2766,6 +2866,11 @@ bool PathsTool::CalculatePath()
 	if(!m_instrstatus.pathmeshvalid)
 		return false;
 
+	// path queries use the published snapshot, not the builder
+	PathsBuilder::t_pathmesh pathmesh = m_pathsbuilder.GetPathMeshSnapshot();
+	if(!pathmesh)
+		return false;
+
 	bool kf_fixed = true;
 	if(!std::get<1>(m_tascalc.GetKfix()))
 		kf_fixed = false;
@@ -2794,7 +2899,7 @@ bool PathsTool::CalculatePath()
 
 	// find path from current to target position
 	SetTmpStatus("Calculating path.");
-	InstrumentPath path = m_pathsbuilder.FindPath(
+	InstrumentPath path = pathmesh->FindPath(
 		curMonoOrAnaScatteringAngle, curSampleScatteringAngle,
 		targetMonoScatteringAngle, targetSampleScatteringAngle,
 		pathstrategy);
@@ -2808,7 +2913,7 @@ bool PathsTool::CalculatePath()
 
 	// get the vertices on the path
 	SetTmpStatus("Retrieving path vertices.");
-	m_pathvertices = m_pathsbuilder.GetPathVertices(path, true, false);
+	m_pathvertices = pathmesh->GetPathVertices(path, true, false);
 	InterpolatePath(m_pathvertices);
 	ValidatePath(m_pathvertices.size() != 0);
 
@@ -2826,7 +2931,7 @@ bool PathsTool::CalculatePath()
 
 		if(g_verifypath)
 		{
-			auto distances = m_pathsbuilder.GetDistancesToNearestWall(m_pathvertices, false);
+			auto distances = pathmesh->GetDistancesToNearestWall(m_pathvertices, false);
 			t_real min_dist = *std::min_element(distances.begin(), distances.end());
 			min_dist = min_dist / tl2::pi<t_real>*t_real(180);
 
@@ -163,6 +163,9 @@ private:
 	// instrument configuration and paths builder
 	InstrumentSpace m_instrspace{};
 	PathsBuilder m_pathsbuilder{};
+
+	// thread pool shared by all calculations
+	std::shared_ptr<ThreadPool> m_threadpool{};
 	bool m_autocalcpath{true};
 
 	// calculated path vertices
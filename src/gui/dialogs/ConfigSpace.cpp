@@ -268,6 +268,12 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 	QAction *acExportNicos = new QAction("To Nicos...", menuFile);
 	menuExportPath->addAction(acExportNicos);
 
+	QAction *acExportBinary = new QAction("To Binary...", menuFile);
+	menuExportPath->addAction(acExportBinary);
+
+	QAction *acExportJsonLines = new QAction("To JSON Lines...", menuFile);
+	menuExportPath->addAction(acExportJsonLines);
+
 	menuFile->addMenu(menuExportPath);
 	menuFile->addSeparator();
 
@@ -492,6 +498,12 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 			case PathsExporterFormat::NICOS:
 				exporter = std::make_shared<PathsExporterNicos>(filename.toStdString());
 				break;
+			case PathsExporterFormat::BINARY:
+				exporter = std::make_shared<PathsExporterBinary>(filename.toStdString());
+				break;
+			case PathsExporterFormat::JSONL:
+				exporter = std::make_shared<PathsExporterJsonLines>(filename.toStdString());
+				break;
 		}
 
 		if(!this->m_pathsbuilder || !exporter)
@@ -500,7 +512,11 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 			return false;
 		}
 
-		if(!m_pathsbuilder->AcceptExporter(exporter.get(), m_pathvertices))
+		// export using the path mesh snapshot that also answers the path queries
+		PathsBuilder::t_pathmesh pathmesh = m_pathsbuilder->GetPathMeshSnapshot();
+		const PathsBuilder *builder = pathmesh ? pathmesh.get() : m_pathsbuilder;
+
+		if(!builder->AcceptExporter(exporter.get(), m_pathvertices))
 		{
 			QMessageBox::critical(this, "Error", "path could not be exported.");
 			return false;
@@ -716,6 +732,16 @@ ConfigSpaceDlg::ConfigSpaceDlg(QWidget* parent, QSettings *sett)
 		exportPath(PathsExporterFormat::NICOS);
 	});
 
+	connect(acExportBinary, &QAction::triggered, this, [exportPath]()
+	{
+		exportPath(PathsExporterFormat::BINARY);
+	});
+
+	connect(acExportJsonLines, &QAction::triggered, this, [exportPath]()
+	{
+		exportPath(PathsExporterFormat::JSONL);
+	});
+
 
 	// file
 	connect(acSaveLines, &QAction::triggered, this, saveLines);
@@ -1061,11 +1087,23 @@ void ConfigSpaceDlg::CalculatePath()
 	if(!m_pathsbuilder)
 		return;
 
+	// path queries use the published snapshot of the path mesh
+	// (the snapshot is withdrawn while the path mesh is invalid or being recalculated)
+	PathsBuilder::t_pathmesh pathmesh = m_pathsbuilder->GetPathMeshSnapshot();
+	if(!pathmesh)
+	{
+		m_status->setText("Error: No valid path mesh is available.");
+		return;
+	}
+
+	// the target position changes more often than the current one,
+	// so reuse the shortest-path tree from the current position
+	std::shared_ptr<const InstrumentPathTree> pathtree = pathmesh->GetPathTree(
+		m_curMonoScatteringAngle, m_curSampleScatteringAngle, m_pathstrategy);
+
 	// find path from current to target position
-	InstrumentPath path = m_pathsbuilder->FindPath(
-		m_curMonoScatteringAngle, m_curSampleScatteringAngle,
-		m_targetMonoScatteringAngle, m_targetSampleScatteringAngle,
-		m_pathstrategy);
+	InstrumentPath path = pathmesh->FindPath(*pathtree,
+		m_targetMonoScatteringAngle, m_targetSampleScatteringAngle);
 
 	if(!path.ok)
 	{
@@ -1079,7 +1117,7 @@ void ConfigSpaceDlg::CalculatePath()
 	else
 	{
 		// get the vertices on the path
-		m_pathvertices = m_pathsbuilder->GetPathVertices(path, m_subdivide_path, true);
+		m_pathvertices = pathmesh->GetPathVertices(path, m_subdivide_path, true);
 	}
 
 	RedrawPathPlot();
@@ -1374,7 +1412,8 @@ bool ConfigSpaceDlg::PathsBuilderProgress(
 
 	if(state == CalculationState::SUCCEEDED ||
 		state == CalculationState::STEP_SUCCEEDED ||
-		state == CalculationState::FAILED)
+		state == CalculationState::FAILED ||
+		state == CalculationState::STEP_FAILED)
 	{
 		if(!hidden)
 		{
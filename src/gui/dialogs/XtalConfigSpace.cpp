@@ -29,7 +29,6 @@
  * ----------------------------------------------------------------------------
  */
 
-#include "src/core/mingw_hacks.h"
 #include "XtalConfigSpace.h"
 
 #include <QtGui/QClipboard>
@@ -43,16 +42,10 @@
 
 #include "src/gui/settings_variables.h"
 
-#include <boost/asio.hpp>
-namespace asio = boost::asio;
-
 #include "tlibs2/libs/maths.h"
 #include "tlibs2/libs/phys.h"
 
 
-using t_task = std::packaged_task<void()>;
-using t_taskptr = std::shared_ptr<t_task>;
-
 
 XtalConfigSpaceDlg::XtalConfigSpaceDlg(QWidget* parent, QSettings *sett)
 	: QDialog{parent}, m_sett{sett}
@@ -478,21 +471,30 @@ void XtalConfigSpaceDlg::Calculate()
 
 	m_img.Init(img_w, img_h);
 
-	// create thread pool
-	asio::thread_pool pool(g_maxnum_threads);
+	// flatten the static walls once for all instrument space copies
+	m_instrspace->GetWallsCollisionScene();
 
-	std::vector<t_taskptr> tasks;
-	tasks.reserve(img_h);
+	// get the (possibly shared) thread pool
+	if(!m_threadpool)
+		m_threadpool = std::make_shared<ThreadPool>(g_maxnum_threads);
 
-	// set image pixels
-	for(std::size_t img_row=0; img_row<img_h; ++img_row)
+	// the instrument space is cloned only once per worker thread
+	WorkerContexts<InstrumentSpace> instrspaces(*m_instrspace, *m_threadpool,
+		[](InstrumentSpace& instrspace_cpy)
 	{
-		t_real yparam = std::lerp(vec2start, vec2end, img_row / t_real(img_h));
+		instrspace_cpy.GetInstrument().SetBlockUpdates(true);
+	});
 
-		auto task = [this, img_w, img_row, vec1start, vec1end, yparam, E]()
+	// set image pixels, the rows are processed in tiles
+	auto task = [this, img_w, img_h, vec1start, vec1end, vec2start, vec2end, E, &instrspaces](
+		std::size_t row_begin, std::size_t row_end, std::size_t worker)
+	{
+		InstrumentSpace& instrspace_cpy = instrspaces.Get(worker);
+		Instrument& instr = instrspace_cpy.GetInstrument();
+
+		for(std::size_t img_row=row_begin; img_row<row_end; ++img_row)
 		{
-			InstrumentSpace instrspace_cpy = *this->m_instrspace;
-			Instrument& instr = instrspace_cpy.GetInstrument();
+			t_real yparam = std::lerp(vec2start, vec2end, img_row / t_real(img_h));
 
 			for(std::size_t img_col=0; img_col<img_w; ++img_col)
 			{
@@ -533,14 +535,8 @@ void XtalConfigSpaceDlg::Calculate()
 					m_img.SetPixel(img_col, img_row, colliding ? 0xff : 0x00);
 				}
 			}
-		};
-
-		t_taskptr taskptr = std::make_shared<t_task>(task);
-		tasks.push_back(taskptr);
-		asio::post(pool, [taskptr]() { (*taskptr)(); });
-	}
-
-	std::size_t num_tasks = tasks.size();
+		}
+	};
 
 
 	// get results
@@ -548,28 +544,23 @@ void XtalConfigSpaceDlg::Calculate()
 	progress->setWindowModality(Qt::WindowModal);
 	progress->setLabelText(
 		QString("Calculating configuration space in %1 threads...")
-			.arg(g_maxnum_threads));
+			.arg(m_threadpool->GetNumThreads()));
 	progress->setAutoReset(true);
 	progress->setAutoClose(true);
 	progress->setMinimumDuration(1000);
 	progress->setMinimum(0);
-	progress->setMaximum(num_tasks);
+	progress->setMaximum(img_h);
 
-	for(std::size_t taskidx=0; taskidx<num_tasks; ++taskidx)
+	m_threadpool->ParallelFor(img_h, 0, task, [this, &progress, img_h](t_real done) -> bool
 	{
-		progress->setValue(taskidx);
-
+		progress->setValue(int(done * t_real(img_h)));
 		if(progress->wasCanceled())
-		{
-			pool.stop();
-			break;
-		}
+			return false;
 
-		tasks[taskidx]->get_future().get();
 		RedrawPlot();
-	}
+		return true;
+	}, instrspaces.GetPrepareFunc());
 
-	pool.join();
-	progress->setValue(num_tasks);
+	progress->setValue(img_h);
 	RedrawPlot();
 }
@@ -38,6 +38,7 @@
 #include "src/libs/img.h"
 #include "src/core/InstrumentSpace.h"
 #include "src/core/TasCalculator.h"
+#include "src/core/ThreadPool.h"
 
 
 class XtalConfigSpaceDlg : public QDialog
@@ -60,6 +61,8 @@ public:
 
 	void SetTasCalculator(const TasCalculator* tascalc) { m_tascalc = tascalc; }
 	const TasCalculator* GetTasCalculator() const { return m_tascalc; }
+
+	void SetThreadPool(const std::shared_ptr<ThreadPool>& pool) { m_threadpool = pool; }
 	// ------------------------------------------------------------------------
 
 
@@ -89,6 +92,7 @@ private:
 
 	const InstrumentSpace *m_instrspace{};
 	const TasCalculator *m_tascalc{};
+	std::shared_ptr<ThreadPool> m_threadpool{};
 
 	geo::Image<std::uint8_t> m_img{};
 	bool m_moveInstr = true;
@@ -119,6 +119,10 @@ public:
 		else
 			g_imgpath = g_docpath;
 
+		if(QStringList cachedirs = QStandardPaths::standardLocations(
+			QStandardPaths::CacheLocation); cachedirs.size())
+			g_cachepath = (cachedirs[0] + QDir::separator() + "pathmeshes").toStdString();
+
 		// override standard paths with own subdir
 		if(g_use_taspaths_subdir)
 		{
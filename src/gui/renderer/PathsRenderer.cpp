@@ -265,7 +265,7 @@ bool PathsRenderer::LoadInstrument(const InstrumentSpace& instrspace)
 					verts, norms, uvs,
 					cols[0], cols[1], cols[2], 1);
 
-				const t_mat& _matGeo = comp->GetTrafo();
+				const t_mat44& _matGeo = comp->GetTrafo();
 				t_mat_gl matGeo = tl2::convert<t_mat_gl>(_matGeo);
 				t_mat_gl mat = matAxis * matGeo;
 
@@ -306,7 +306,7 @@ void PathsRenderer::AddWall(const Geometry& wall)
 		wall.GetId(), verts, norms, uvs,
 		cols[0], cols[1], cols[2], 1);
 
-	const t_mat& _mat = wall.GetTrafo();
+	const t_mat44& _mat = wall.GetTrafo();
 	t_mat_gl mat = tl2::convert<t_mat_gl>(_mat);
 	obj_iter->second.m_mat = mat;
 	obj_iter->second.m_texture = wall.GetTexture();
@@ -323,7 +323,7 @@ void PathsRenderer::UpdateInstrumentSpace(const InstrumentSpace& instr)
 	// update wall matrices
 	for(const auto& wall : instr.GetWalls())
 	{
-		m_objs[wall->GetId()].m_mat = wall->GetTrafo();
+		m_objs[wall->GetId()].m_mat = tl2::convert<t_mat_gl>(wall->GetTrafo());
 	}
 
 	update();
@@ -357,7 +357,7 @@ void PathsRenderer::UpdateInstrument(const Instrument& instr)
 				if(iter == m_objs.end())
 					continue;
 
-				const t_mat& _matGeo = comp->GetTrafo();
+				const t_mat44& _matGeo = comp->GetTrafo();
 				t_mat_gl matGeo = tl2::convert<t_mat_gl>(_matGeo);
 				t_mat_gl mat = matAxis * matGeo;
 
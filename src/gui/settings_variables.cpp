@@ -43,6 +43,7 @@ std::string g_homepath = "~/";
 std::string g_desktoppath = g_homepath;
 std::string g_docpath = g_homepath;
 std::string g_imgpath = g_homepath;
+std::string g_cachepath = "";
 
 #if BOOST_OS_MACOS
 	int g_use_taspaths_subdir = 1;
@@ -78,6 +79,13 @@ t_real g_a4_delta = 1. / 180. * tl2::pi<t_real>;
 // 0: sweep, 1: half-plane test
 int g_poly_intersection_method = 1;
 
+// how to sample the configuration space?
+// 0: full, 1: adaptive, 2: boundary tracing
+int g_cfgspace_sampling = 0;
+
+// angular size of the coarse cells for adaptive and boundary sampling
+t_real g_cfgspace_cellsize = 4. / 180. * tl2::pi<t_real>;
+
 // which backend to use for contour calculation?
 // 0: internal, 1: opencv
 int g_contour_backend = 0;
@@ -92,11 +100,17 @@ int g_use_region_function = 1;
 // use bisector verification function
 int g_remove_bisectors_below_min_wall_dist = 0;
 
+// cache calculated path meshes on disk
+int g_use_pathmesh_cache = 1;
+
 
 // path-finding options
 int g_pathstrategy = 0;
+// 0: dijkstra, 1: a*, 2: bidirectional dijkstra
+int g_pathsearch = 1;
 int g_try_direct_path = 1;
 int g_verifypath = 1;
+t_real g_verifypath_geo_step = 0.;
 
 // number of closest voronoi vertices to consider for retraction point search
 unsigned int g_num_closest_voronoi_vertices = 64;
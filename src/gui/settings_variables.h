@@ -60,6 +60,9 @@ extern std::string g_desktoppath;
 extern std::string g_docpath;
 extern std::string g_imgpath;
 
+// directory for cached path meshes
+extern std::string g_cachepath;
+
 // create a subdirectory under the home directory for taspaths files
 extern int g_use_taspaths_subdir;
 
@@ -93,6 +96,14 @@ extern t_real g_a4_delta;
 // 0: sweep, 1: half-plane test
 extern int g_poly_intersection_method;
 
+// how to sample the configuration space?
+// 0: full, 1: adaptive, 2: boundary tracing
+// (adaptive and boundary sampling miss obstacles smaller than a coarse cell)
+extern int g_cfgspace_sampling;
+
+// angular size of the coarse cells for adaptive and boundary sampling
+extern t_real g_cfgspace_cellsize;
+
 // which backend to use for contour calculation?
 // 0: internal, 1: opencv
 extern int g_contour_backend;
@@ -107,11 +118,18 @@ extern int g_use_region_function;
 // use bisector verification function
 extern int g_remove_bisectors_below_min_wall_dist;
 
+// cache calculated path meshes on disk
+extern int g_use_pathmesh_cache;
+
 
 // which path finding strategy to use?
 // 0: shortest path, 1: avoid walls
 extern int g_pathstrategy;
 
+// which algorithm to use for searching the path mesh?
+// 0: dijkstra, 1: a*, 2: bidirectional dijkstra
+extern int g_pathsearch;
+
 // choose a direct path if possible
 extern int g_try_direct_path;
 
@@ -121,6 +139,9 @@ extern t_real g_directpath_search_radius;
 // verify the generated path?
 extern int g_verifypath;
 
+// angular step for re-checking the path against the full instrument geometry
+extern t_real g_verifypath_geo_step;
+
 // number of closest voronoi vertices to consider for retraction point search
 extern unsigned int g_num_closest_voronoi_vertices;
 
@@ -187,7 +208,7 @@ extern int g_nested_docks;
 // ----------------------------------------------------------------------------
 // variables register
 // ----------------------------------------------------------------------------
-constexpr std::array<SettingsVariable, 31> g_settingsvariables
+constexpr std::array<SettingsVariable, 36> g_settingsvariables
 {{
 	// epsilons and precisions
 	{
@@ -270,6 +291,19 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.editor = SettingsVariableEditor::COMBOBOX,
 		.editor_config = "Sweep;;Half-plane Test",
 	},
+	{
+		.description = "Configuration space sampling (careful: adaptive and boundary sampling miss obstacles smaller than a cell!).",
+		.key = "settings/cfgspace_sampling",
+		.value = &g_cfgspace_sampling,
+		.editor = SettingsVariableEditor::COMBOBOX,
+		.editor_config = "Full;;Adaptive;;Boundary Tracing",
+	},
+	{
+		.description = "Cell size for adaptive and boundary sampling, has to be smaller than the smallest obstacle.",
+		.key = "settings/cfgspace_cellsize",
+		.value = &g_cfgspace_cellsize,
+		.is_angle = true,
+	},
 	{
 		.description = "Contour calculation backend.",
 		.key = "settings/contour_backend",
@@ -296,6 +330,12 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.value = &g_remove_bisectors_below_min_wall_dist,
 		.editor = SettingsVariableEditor::YESNO,
 	},
+	{
+		.description = "Cache calculated path meshes on disk.",
+		.key = "settings/use_pathmesh_cache",
+		.value = &g_use_pathmesh_cache,
+		.editor = SettingsVariableEditor::YESNO,
+	},
 
 	// path options
 	{
@@ -305,6 +345,13 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.editor = SettingsVariableEditor::COMBOBOX,
 		.editor_config = "Shortest Path;;Avoid Walls",
 	},
+	{
+		.description = "Path mesh search algorithm.",
+		.key = "settings/path_search",
+		.value = &g_pathsearch,
+		.editor = SettingsVariableEditor::COMBOBOX,
+		.editor_config = "Dijkstra;;A*;;Bidirectional Dijkstra",
+	},
 	{
 		.description = "Try using direct path segments.",
 		.key = "settings/try_direct_path",
@@ -323,6 +370,12 @@ constexpr std::array<SettingsVariable, 31> g_settingsvariables
 		.value = &g_verifypath,
 		.editor = SettingsVariableEditor::YESNO,
 	},
+	{
+		.description = "Angular step for verifying the path against the instrument geometry (0: off).",
+		.key = "settings/verify_path_geometry_step",
+		.value = &g_verifypath_geo_step,
+		.is_angle = true,
+	},
 	{
 		.description = "Number of closest voronoi vertices for retraction point search.",
 		.key = "settings/num_closest_voronoi_vertices",
@@ -48,6 +48,11 @@
 #include <stack>
 #include <set>
 #include <unordered_set>
+#include <unordered_map>
+#include <tuple>
+#include <string>
+#include <memory>
+#include <utility>
 #include <algorithm>
 #include <optional>
 #include <iostream>
@@ -700,6 +705,566 @@ private:
 	std::vector<std::string> m_vertexidents{};
 	std::vector<std::shared_ptr<AdjNode>> m_nodes{};
 };
+
+
+
+/**
+ * adjacency list in compressed sparse row format,
+ * edges are first collected and then compacted into contiguous arrays by Finalise()
+ * @see https://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_(CSR,_CRS_or_Yale_format)
+ */
+template<class _t_weight = unsigned int>
+class CompressedAdjacencyList
+{
+public:
+	using t_weight = _t_weight;
+
+
+public:
+	CompressedAdjacencyList() = default;
+	~CompressedAdjacencyList() = default;
+
+
+	void Clear()
+	{
+		m_vertexidents.clear();
+		m_vertexindices.clear();
+		m_offsets.clear();
+		m_neighbours.clear();
+		m_weights.clear();
+		m_pending.clear();
+	}
+
+
+	std::size_t GetNumVertices() const
+	{
+		return m_vertexidents.size();
+	}
+
+
+	const std::string& GetVertexIdent(std::size_t i) const
+	{
+		return m_vertexidents[i];
+	}
+
+
+	std::optional<std::size_t> GetVertexIndex(const std::string& vert) const
+	{
+		auto iter = m_vertexindices.find(vert);
+		if(iter == m_vertexindices.end())
+			return std::nullopt;
+
+		return iter->second;
+	}
+
+
+	void AddVertex(const std::string& id)
+	{
+		m_vertexindices.emplace(id, m_vertexidents.size());
+		m_vertexidents.push_back(id);
+
+		// the new vertex has no compacted edges yet
+		if(m_offsets.empty())
+			m_offsets.push_back(0);
+		m_offsets.push_back(m_offsets.back());
+	}
+
+
+	void RemoveVertex(std::size_t idx)
+	{
+		if(idx >= GetNumVertices())
+			return;
+		Finalise();
+
+		// remove the vertex and all its edges
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> neighbours;
+		std::vector<t_weight> weights;
+		offsets.reserve(m_offsets.size() - 1);
+		neighbours.reserve(m_neighbours.size());
+		weights.reserve(m_weights.size());
+		offsets.push_back(0);
+
+		for(std::size_t idx1=0; idx1<GetNumVertices(); ++idx1)
+		{
+			if(idx1 == idx)
+				continue;
+
+			for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+			{
+				std::size_t idx2 = m_neighbours[edge];
+				if(idx2 == idx)
+					continue;
+
+				// fix indices
+				neighbours.push_back(idx2 > idx ? idx2 - 1 : idx2);
+				weights.push_back(m_weights[edge]);
+			}
+
+			offsets.push_back(neighbours.size());
+		}
+
+		m_offsets = std::move(offsets);
+		m_neighbours = std::move(neighbours);
+		m_weights = std::move(weights);
+
+		m_vertexindices.erase(m_vertexidents[idx]);
+		m_vertexidents.erase(m_vertexidents.begin() + idx);
+		for(std::size_t idx1=idx; idx1<m_vertexidents.size(); ++idx1)
+			m_vertexindices[m_vertexidents[idx1]] = idx1;
+	}
+
+
+	void RemoveVertex(const std::string& id)
+	{
+		if(auto idx = GetVertexIndex(id); idx)
+			RemoveVertex(*idx);
+	}
+
+
+	void SetWeight(std::size_t idx1, std::size_t idx2, t_weight w)
+	{
+		if(t_weight* weight = FindWeight(idx1, idx2); weight)
+			*weight = w;
+	}
+
+
+	void SetWeight(const std::string& vert1, const std::string& vert2, t_weight w)
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(idx1 && idx2)
+			SetWeight(*idx1, *idx2, w);
+	}
+
+
+	std::optional<t_weight> GetWeight(std::size_t idx1, std::size_t idx2) const
+	{
+		if(const t_weight* weight = FindWeight(idx1, idx2); weight)
+			return *weight;
+
+		return std::nullopt;
+	}
+
+
+	std::optional<t_weight> GetWeight(const std::string& vert1, const std::string& vert2) const
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(idx1 && idx2)
+			return GetWeight(*idx1, *idx2);
+
+		return std::nullopt;
+	}
+
+
+	void AddEdge(std::size_t idx1, std::size_t idx2, t_weight w=0)
+	{
+		if(idx1 >= GetNumVertices() || idx2 >= GetNumVertices())
+			return;
+
+		// duplicate edges are resolved in Finalise()
+		m_pending.emplace_back(std::make_tuple(idx1, idx2, w));
+	}
+
+
+	void AddEdge(const std::string& vert1, const std::string& vert2, t_weight w=0)
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(!idx1 || !idx2)
+			return;
+
+		AddEdge(*idx1, *idx2, w);
+	}
+
+
+	void RemoveEdge(std::size_t idx1, std::size_t idx2)
+	{
+		if(idx1 >= GetNumVertices())
+			return;
+		Finalise();
+
+		for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+		{
+			if(m_neighbours[edge] != idx2)
+				continue;
+
+			m_neighbours.erase(m_neighbours.begin() + edge);
+			m_weights.erase(m_weights.begin() + edge);
+			for(std::size_t idx=idx1+1; idx<m_offsets.size(); ++idx)
+				--m_offsets[idx];
+			break;
+		}
+	}
+
+
+	void RemoveEdge(const std::string& vert1, const std::string& vert2)
+	{
+		auto idx1 = GetVertexIndex(vert1);
+		auto idx2 = GetVertexIndex(vert2);
+
+		if(!idx1 || !idx2)
+			return;
+
+		RemoveEdge(*idx1, *idx2);
+	}
+
+
+	bool IsAdjacent(std::size_t idx1, std::size_t idx2) const
+	{
+		return GetWeight(idx1, idx2).has_value();
+	}
+
+
+	bool IsAdjacent(const std::string& vert1, const std::string& vert2) const
+	{
+		return GetWeight(vert1, vert2).has_value();
+	}
+
+
+	std::vector<std::size_t> GetNeighbours(std::size_t idx, bool outgoing_edges=true) const
+	{
+		std::vector<std::size_t> neighbours;
+
+		// neighbour vertices on outgoing edges
+		if(outgoing_edges)
+		{
+			neighbours.assign(m_neighbours.begin() + m_offsets[idx],
+				m_neighbours.begin() + m_offsets[idx + 1]);
+
+			for(const auto& [idx1, idx2, w] : m_pending)
+			{
+				if(idx1 == idx)
+					neighbours.push_back(idx2);
+			}
+		}
+
+		// neighbour vertices on incoming edges
+		else
+		{
+			for(std::size_t idx1=0; idx1<GetNumVertices(); ++idx1)
+			{
+				for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+				{
+					if(m_neighbours[edge] == idx)
+					{
+						neighbours.push_back(idx1);
+						break;
+					}
+				}
+			}
+
+			for(const auto& [idx1, idx2, w] : m_pending)
+			{
+				if(idx2 == idx)
+					neighbours.push_back(idx1);
+			}
+		}
+
+		return neighbours;
+	}
+
+
+	std::vector<std::string> GetNeighbours(const std::string& vert, bool outgoing_edges=true) const
+	{
+		auto idx = GetVertexIndex(vert);
+		if(!idx)
+			return {};
+
+		std::vector<std::size_t> neighbour_indices = GetNeighbours(*idx, outgoing_edges);
+
+		std::vector<std::string> neighbours;
+		neighbours.reserve(neighbour_indices.size());
+
+		for(std::size_t neighbour_index : neighbour_indices)
+			neighbours.push_back(GetVertexIdent(neighbour_index));
+
+		return neighbours;
+	}
+
+
+	/**
+	 * compact the collected edges into the contiguous neighbour and weight arrays
+	 */
+	void Finalise()
+	{
+		if(m_pending.empty())
+			return;
+
+		const std::size_t N = GetNumVertices();
+
+		// count the edges per vertex
+		std::vector<std::size_t> offsets(N + 1, 0);
+		for(std::size_t idx1=0; idx1<N; ++idx1)
+			offsets[idx1 + 1] = m_offsets[idx1 + 1] - m_offsets[idx1];
+		for(const auto& [idx1, idx2, w] : m_pending)
+			++offsets[idx1 + 1];
+		for(std::size_t idx1=0; idx1<N; ++idx1)
+			offsets[idx1 + 1] += offsets[idx1];
+
+		std::vector<std::size_t> neighbours(offsets[N]);
+		std::vector<t_weight> weights(offsets[N]);
+		std::vector<std::size_t> insert_pos(offsets.begin(), offsets.end() - 1);
+
+		// already compacted edges
+		for(std::size_t idx1=0; idx1<N; ++idx1)
+		{
+			for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+			{
+				std::size_t pos = insert_pos[idx1]++;
+				neighbours[pos] = m_neighbours[edge];
+				weights[pos] = m_weights[edge];
+			}
+		}
+
+		// new edges
+		for(const auto& [idx1, idx2, w] : m_pending)
+		{
+			std::size_t pos = insert_pos[idx1]++;
+			neighbours[pos] = idx2;
+			weights[pos] = w;
+		}
+
+		// remove duplicate edges, keeping the most recently added ones
+		std::size_t num_edges = 0;
+		for(std::size_t idx1=0; idx1<N; ++idx1)
+		{
+			const std::size_t row_begin = offsets[idx1];
+			const std::size_t row_end = offsets[idx1 + 1];
+			offsets[idx1] = num_edges;
+
+			for(std::size_t edge=row_begin; edge<row_end; ++edge)
+			{
+				if(std::find(neighbours.begin() + edge + 1, neighbours.begin() + row_end,
+					neighbours[edge]) != neighbours.begin() + row_end)
+					continue;
+
+				neighbours[num_edges] = neighbours[edge];
+				weights[num_edges] = weights[edge];
+				++num_edges;
+			}
+		}
+		offsets[N] = num_edges;
+		neighbours.resize(num_edges);
+		weights.resize(num_edges);
+
+		m_offsets = std::move(offsets);
+		m_neighbours = std::move(neighbours);
+		m_weights = std::move(weights);
+		m_pending.clear();
+	}
+
+
+protected:
+	/**
+	 * find the weight of an edge in the collected or in the compacted edges,
+	 * the most recently added edges are searched first
+	 */
+	const t_weight* FindWeight(std::size_t idx1, std::size_t idx2) const
+	{
+		if(idx1 >= GetNumVertices())
+			return nullptr;
+
+		for(auto iter = m_pending.rbegin(); iter != m_pending.rend(); ++iter)
+		{
+			const auto& [pending_idx1, pending_idx2, w] = *iter;
+			if(pending_idx1 == idx1 && pending_idx2 == idx2)
+				return &w;
+		}
+
+		for(std::size_t edge=m_offsets[idx1]; edge<m_offsets[idx1 + 1]; ++edge)
+		{
+			if(m_neighbours[edge] == idx2)
+				return &m_weights[edge];
+		}
+
+		return nullptr;
+	}
+
+
+	t_weight* FindWeight(std::size_t idx1, std::size_t idx2)
+	{
+		return const_cast<t_weight*>(std::as_const(*this).FindWeight(idx1, idx2));
+	}
+
+
+private:
+	std::vector<std::string> m_vertexidents{};
+	std::unordered_map<std::string, std::size_t> m_vertexindices{};
+
+	// edges of vertex i are stored in the range [m_offsets[i], m_offsets[i+1])
+	std::vector<std::size_t> m_offsets{};
+	std::vector<std::size_t> m_neighbours{};
+	std::vector<t_weight> m_weights{};
+
+	// edges which have not yet been compacted
+	std::vector<std::tuple<std::size_t, std::size_t, t_weight>> m_pending{};
+};
+
+
+
+/**
+ * indexed d-ary min-heap of the vertex indices [0, N), ordered by their keys,
+ * supports changing the key of a vertex that is already in the heap
+ * @see https://en.wikipedia.org/wiki/D-ary_heap
+ */
+template<class _t_key, std::size_t D = 4>
+class IndexedHeap
+{
+public:
+	using t_key = _t_key;
+
+	static_assert(D >= 2, "The heap needs at least two children per node.");
+
+
+public:
+	IndexedHeap(std::size_t N = 0)
+		: m_positions(N, not_in_heap)
+	{}
+
+	~IndexedHeap() = default;
+
+
+	bool Empty() const
+	{
+		return m_heap.empty();
+	}
+
+
+	std::size_t Size() const
+	{
+		return m_heap.size();
+	}
+
+
+	bool Contains(std::size_t idx) const
+	{
+		return idx < m_positions.size() && m_positions[idx] != not_in_heap;
+	}
+
+
+	/**
+	 * vertex index with the smallest key
+	 */
+	std::size_t Top() const
+	{
+		return m_heap.front().second;
+	}
+
+
+	const t_key& TopKey() const
+	{
+		return m_heap.front().first;
+	}
+
+
+	/**
+	 * insert a vertex index or change its key if it is already in the heap
+	 */
+	void Push(std::size_t idx, const t_key& key)
+	{
+		if(idx >= m_positions.size())
+			m_positions.resize(idx + 1, not_in_heap);
+
+		if(std::size_t pos = m_positions[idx]; pos != not_in_heap)
+		{
+			// change the key of an existing element
+			const bool decrease = key < m_heap[pos].first;
+			m_heap[pos].first = key;
+
+			if(decrease)
+				SiftUp(pos);
+			else
+				SiftDown(pos);
+		}
+		else
+		{
+			// insert a new element
+			m_heap.emplace_back(key, idx);
+			m_positions[idx] = m_heap.size() - 1;
+			SiftUp(m_heap.size() - 1);
+		}
+	}
+
+
+	/**
+	 * remove the vertex index with the smallest key
+	 */
+	std::size_t Pop()
+	{
+		const std::size_t idx = Top();
+
+		Swap(0, m_heap.size() - 1);
+		m_heap.pop_back();
+		m_positions[idx] = not_in_heap;
+
+		if(!m_heap.empty())
+			SiftDown(0);
+
+		return idx;
+	}
+
+
+protected:
+	void Swap(std::size_t pos1, std::size_t pos2)
+	{
+		std::swap(m_heap[pos1], m_heap[pos2]);
+		m_positions[m_heap[pos1].second] = pos1;
+		m_positions[m_heap[pos2].second] = pos2;
+	}
+
+
+	void SiftUp(std::size_t pos)
+	{
+		while(pos > 0)
+		{
+			const std::size_t parent = (pos - 1) / D;
+			if(!(m_heap[pos].first < m_heap[parent].first))
+				break;
+
+			Swap(pos, parent);
+			pos = parent;
+		}
+	}
+
+
+	void SiftDown(std::size_t pos)
+	{
+		while(true)
+		{
+			// find the child with the smallest key
+			const std::size_t first_child = pos*D + 1;
+			const std::size_t end_child = std::min(first_child + D, m_heap.size());
+			std::size_t min_pos = pos;
+
+			for(std::size_t child=first_child; child<end_child; ++child)
+			{
+				if(m_heap[child].first < m_heap[min_pos].first)
+					min_pos = child;
+			}
+
+			if(min_pos == pos)
+				break;
+
+			Swap(pos, min_pos);
+			pos = min_pos;
+		}
+	}
+
+
+private:
+	static constexpr std::size_t not_in_heap = std::numeric_limits<std::size_t>::max();
+
+	// heap of keys and vertex indices
+	std::vector<std::pair<t_key, std::size_t>> m_heap{};
+
+	// position of every vertex index in the heap
+	std::vector<std::size_t> m_positions{};
+};
 // ----------------------------------------------------------------------------
 
 
@@ -708,6 +1273,18 @@ private:
 // algorithms
 // ----------------------------------------------------------------------------
 
+/**
+ * compact the graph after all vertices and edges have been inserted,
+ * if the graph container supports this
+ */
+template<class t_graph> requires is_graph<t_graph>
+void finalise_graph(t_graph& graph)
+{
+	if constexpr(requires { graph.Finalise(); })
+		graph.Finalise();
+}
+
+
 /**
  * export graph to the dot format
  * @see https://graphviz.org/doc/info/lang.html
@@ -745,6 +1322,7 @@ bool print_graph(const t_graph& graph, std::ostream& ostr = std::cout)
 
 /**
  * dijkstra algorithm
+ * @arg dists_out optionally receives the distances of all vertices from the start vertex
  * @see (FUH 2021), Kurseinheit 4, p. 17
  * @see (Erickson 2019), p. 288
  */
@@ -754,7 +1332,8 @@ template<class t_graph,
 requires is_graph<t_graph>
 std::vector<std::optional<std::size_t>>
 dijk(const t_graph& graph, const std::string& startvert,
-	t_weight_func *weight_func = nullptr)
+	t_weight_func *weight_func = nullptr,
+	std::vector<typename t_graph::t_weight> *dists_out = nullptr)
 {
 	// start index
 	auto _startidx = graph.GetVertexIndex(startvert);
@@ -778,31 +1357,16 @@ dijk(const t_graph& graph, const std::string& startvert,
 		dists[vertidx] = (vertidx==startidx ? 0 : infinity);
 
 
-	// comparator for distances heap
-	auto vert_cmp = [&dists](std::size_t idx1, std::size_t idx2) -> bool
-	{
-		return dists[idx1] >= dists[idx2];
-	};
+	// vertex distances heap, only vertices which have been reached are inserted
+	IndexedHeap<t_weight> distheap(N);
+	std::vector<bool> finished(N, false);
+	distheap.Push(startidx, dists[startidx]);
 
-	// vertex distances heap
-	std::vector<std::size_t> distheap;
-	distheap.reserve(N);
-
-	for(std::size_t vertidx=0; vertidx<N; ++vertidx)
-		distheap.push_back(vertidx);
 
-	std::make_heap(distheap.begin(), distheap.end(), vert_cmp);
-
-
-	while(!distheap.empty())
+	while(!distheap.Empty())
 	{
 #ifdef DIJK_DEBUG
 		std::cout << "\nNew iteration.\n";
-		std::cout << "Vertex indices in distances heap:\n";
-		for(std::size_t idx : distheap)
-			std::cout << idx << " (dist: " << dists[idx] << "), ";
-		std::cout << "." << std::endl;
-
 		std::cout << "Predecessor indices:\n";
 		for(const auto& pred : predecessors)
 		{
@@ -814,9 +1378,8 @@ dijk(const t_graph& graph, const std::string& startvert,
 		}
 		std::cout << std::endl;
 #endif
-		std::size_t vertidx = distheap.front();
-		std::pop_heap(distheap.begin(), distheap.end(), vert_cmp);
-		distheap.pop_back();
+		std::size_t vertidx = distheap.Pop();
+		finished[vertidx] = true;
 
 		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx);
 		for(std::size_t neighbouridx : neighbours)
@@ -850,8 +1413,9 @@ dijk(const t_graph& graph, const std::string& startvert,
 				dists[neighbouridx] = dists[vertidx] + *w;
 				predecessors[neighbouridx] = vertidx;
 
-				// resort the heap after the distance changes
-				std::make_heap(distheap.begin(), distheap.end(), vert_cmp);
+				// insert the vertex or decrease its key in the heap
+				if(!finished[neighbouridx])
+					distheap.Push(neighbouridx, dists[neighbouridx]);
 			}
 		}
 	}
@@ -875,6 +1439,9 @@ dijk(const t_graph& graph, const std::string& startvert,
 		std::cout << std::endl;
 #endif
 
+	if(dists_out)
+		*dists_out = std::move(dists);
+
 	return predecessors;
 }
 
@@ -911,28 +1478,16 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 	for(std::size_t vertidx=0; vertidx<N; ++vertidx)
 		dists[vertidx] = (vertidx==startidx ? 0 : infinity);
 
-	// distance priority queue and comparator
-	auto vert_cmp = [&dists](std::size_t idx1, std::size_t idx2) -> bool
-	{
-		// sort by ascending value: !operator<
-		return dists[idx1] >= dists[idx2];
-	};
-
-	std::vector<std::size_t> distheap;
-	distheap.reserve(N);
+	// distance priority queue
+	IndexedHeap<t_weight> distheap(N);
 
 	// push only start index, not all indices
-	distheap.push_back(startidx);
+	distheap.Push(startidx, dists[startidx]);
 
-	while(distheap.size())
+	while(!distheap.Empty())
 	{
 #ifdef DIJK_DEBUG
 		std::cout << "\nNew iteration.\n";
-		std::cout << "Vertex indices in distances heap:\n";
-		for(std::size_t idx : distheap)
-			std::cout << idx << " (dist: " << dists[idx] << "), ";
-		std::cout << "." << std::endl;
-
 		std::cout << "Predecessor indices:\n";
 		for(const auto& pred : predecessors)
 		{
@@ -945,9 +1500,7 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 		std::cout << std::endl;
 #endif
 
-		std::size_t vertidx = *distheap.begin();
-		std::pop_heap(distheap.begin(), distheap.end(), vert_cmp);
-		distheap.pop_back();
+		std::size_t vertidx = distheap.Pop();
 
 		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx);
 		for(std::size_t neighbouridx : neighbours)
@@ -981,12 +1534,9 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 				dists[neighbouridx] = dists[vertidx] + *w;
 				predecessors[neighbouridx] = vertidx;
 
-				// insert the new node index if it's not in the queue yet
-				if(std::find(distheap.begin(), distheap.end(), neighbouridx) == distheap.end())
-					distheap.push_back(neighbouridx);
-
-				// resort the priority queue heap after neighbouridx distance changes
-				std::make_heap(distheap.begin(), distheap.end(), vert_cmp);
+				// insert the new node index if it's not in the queue yet,
+				// otherwise decrease its key (vertices may be visited again for negative weights)
+				distheap.Push(neighbouridx, dists[neighbouridx]);
 			}
 		}
 	}
@@ -1014,6 +1564,217 @@ dijk_mod(const t_graph& graph, const std::string& startvert,
 }
 
 
+/**
+ * a* algorithm: dijkstra search directed towards a goal vertex,
+ * which stops as soon as the goal has been reached
+ * @arg heuristic_func lower bound of the distance from a vertex to the goal,
+ *      needs to be admissible for the found path to be the shortest one
+ * @returns predecessors, only the ones on the path to the goal are complete
+ * @see https://en.wikipedia.org/wiki/A*_search_algorithm
+ */
+template<class t_graph,
+	class t_heuristic_func = typename t_graph::t_weight(std::size_t),
+	class t_weight_func =
+		std::optional<typename t_graph::t_weight>(std::size_t, std::size_t)>
+requires is_graph<t_graph>
+std::vector<std::optional<std::size_t>>
+astar(const t_graph& graph, const std::string& startvert, const std::string& goalvert,
+	t_heuristic_func *heuristic_func = nullptr, t_weight_func *weight_func = nullptr)
+{
+	// start and goal indices
+	auto _startidx = graph.GetVertexIndex(startvert);
+	auto _goalidx = graph.GetVertexIndex(goalvert);
+	if(!_startidx || !_goalidx)
+		return {};
+	const std::size_t startidx = *_startidx;
+	const std::size_t goalidx = *_goalidx;
+
+	// distances
+	const std::size_t N = graph.GetNumVertices();
+	using t_weight = typename t_graph::t_weight;
+
+	std::vector<t_weight> dists;
+	std::vector<std::optional<std::size_t>> predecessors;
+	std::vector<bool> finished;
+	dists.resize(N);
+	predecessors.resize(N);
+	finished.resize(N, false);
+
+	// don't use the full maximum to prevent overflows when we're adding the weight afterwards
+	const t_weight infinity = std::numeric_limits<t_weight>::max() / 2;
+	for(std::size_t vertidx=0; vertidx<N; ++vertidx)
+		dists[vertidx] = (vertidx==startidx ? 0 : infinity);
+
+	auto get_estimate = [heuristic_func](std::size_t vertidx) -> t_weight
+	{
+		if(!heuristic_func)
+			return 0;
+		return (*heuristic_func)(vertidx);
+	};
+
+	// priority queue of the estimated total distances
+	IndexedHeap<t_weight> distheap(N);
+	distheap.Push(startidx, get_estimate(startidx));
+
+	while(!distheap.Empty())
+	{
+		std::size_t vertidx = distheap.Pop();
+		finished[vertidx] = true;
+
+		// goal reached
+		if(vertidx == goalidx)
+			break;
+
+		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx);
+		for(std::size_t neighbouridx : neighbours)
+		{
+			// edge weight
+			std::optional<typename t_graph::t_weight> w;
+
+			// directly get edge weight, or use user-supplied weight function
+			if(!weight_func)
+				w = graph.GetWeight(vertidx, neighbouridx);
+			else
+				w = (*weight_func)(vertidx, neighbouridx);
+
+			if(!w)
+				continue;
+
+			// is the path from startidx to neighbouridx over vertidx shorter than from startidx to neighbouridx?
+			if(dists[vertidx] + *w < dists[neighbouridx])
+			{
+				dists[neighbouridx] = dists[vertidx] + *w;
+				predecessors[neighbouridx] = vertidx;
+
+				if(!finished[neighbouridx])
+					distheap.Push(neighbouridx, dists[neighbouridx] + get_estimate(neighbouridx));
+			}
+		}
+	}
+
+	return predecessors;
+}
+
+
+/**
+ * bidirectional dijkstra algorithm: searches from the start and from the goal vertex
+ * at the same time and stops when the two search fronts have met
+ * @arg symmetric if the graph is symmetric, the outgoing edges are also used as incoming ones
+ * @returns predecessors, only the ones on the path to the goal are complete
+ * @see https://en.wikipedia.org/wiki/Bidirectional_search
+ */
+template<class t_graph,
+	class t_weight_func =
+		std::optional<typename t_graph::t_weight>(std::size_t, std::size_t)>
+requires is_graph<t_graph>
+std::vector<std::optional<std::size_t>>
+dijk_bidir(const t_graph& graph, const std::string& startvert, const std::string& goalvert,
+	t_weight_func *weight_func = nullptr, bool symmetric = true)
+{
+	// start and goal indices
+	auto _startidx = graph.GetVertexIndex(startvert);
+	auto _goalidx = graph.GetVertexIndex(goalvert);
+	if(!_startidx || !_goalidx)
+		return {};
+	const std::size_t startidx = *_startidx;
+	const std::size_t goalidx = *_goalidx;
+
+	const std::size_t N = graph.GetNumVertices();
+	using t_weight = typename t_graph::t_weight;
+
+	// don't use the full maximum to prevent overflows when we're adding the weight afterwards
+	const t_weight infinity = std::numeric_limits<t_weight>::max() / 2;
+
+	// search state in forward (0) and backward (1) direction
+	std::vector<t_weight> dists[2];
+	std::vector<std::optional<std::size_t>> predecessors[2];
+	std::vector<bool> finished[2];
+	IndexedHeap<t_weight> distheap[2] = { IndexedHeap<t_weight>(N), IndexedHeap<t_weight>(N) };
+
+	for(int dir=0; dir<2; ++dir)
+	{
+		dists[dir].resize(N, infinity);
+		predecessors[dir].resize(N);
+		finished[dir].resize(N, false);
+	}
+
+	dists[0][startidx] = 0;
+	dists[1][goalidx] = 0;
+	distheap[0].Push(startidx, 0);
+	distheap[1].Push(goalidx, 0);
+
+	// length of the best path found so far and the vertex where both searches meet
+	t_weight best_dist = infinity;
+	std::optional<std::size_t> meetidx;
+	if(startidx == goalidx)
+	{
+		best_dist = 0;
+		meetidx = startidx;
+	}
+
+	while(!distheap[0].Empty() && !distheap[1].Empty())
+	{
+		// no shorter path can be found anymore
+		if(distheap[0].TopKey() + distheap[1].TopKey() >= best_dist)
+			break;
+
+		// advance the search with the smaller front
+		const int dir = (distheap[0].Size() <= distheap[1].Size()) ? 0 : 1;
+
+		std::size_t vertidx = distheap[dir].Pop();
+		finished[dir][vertidx] = true;
+
+		std::vector<std::size_t> neighbours = graph.GetNeighbours(vertidx, dir == 0 || symmetric);
+		for(std::size_t neighbouridx : neighbours)
+		{
+			// edge weight in the direction of the path
+			std::size_t idx1 = (dir == 0 ? vertidx : neighbouridx);
+			std::size_t idx2 = (dir == 0 ? neighbouridx : vertidx);
+			std::optional<typename t_graph::t_weight> w;
+
+			// directly get edge weight, or use user-supplied weight function
+			if(!weight_func)
+				w = graph.GetWeight(idx1, idx2);
+			else
+				w = (*weight_func)(idx1, idx2);
+
+			if(!w)
+				continue;
+
+			if(dists[dir][vertidx] + *w < dists[dir][neighbouridx])
+			{
+				dists[dir][neighbouridx] = dists[dir][vertidx] + *w;
+				predecessors[dir][neighbouridx] = vertidx;
+				if(!finished[dir][neighbouridx])
+					distheap[dir].Push(neighbouridx, dists[dir][neighbouridx]);
+			}
+
+			// connect both searches
+			t_weight dist = dists[0][neighbouridx] + dists[1][neighbouridx];
+			if(dist < best_dist)
+			{
+				best_dist = dist;
+				meetidx = neighbouridx;
+			}
+		}
+	}
+
+	if(!meetidx)
+		return {};
+
+	// join the forward predecessors with the reversed backward ones
+	std::vector<std::optional<std::size_t>> predecessors_path = std::move(predecessors[0]);
+	for(std::size_t vertidx = *meetidx; predecessors[1][vertidx];)
+	{
+		std::size_t nextidx = *predecessors[1][vertidx];
+		predecessors_path[nextidx] = vertidx;
+		vertidx = nextidx;
+	}
+
+	return predecessors_path;
+}
+
+
 /**
  * bellman-ford algorithm
  * @see (FUH 2021), Kurseinheit 4, p. 13
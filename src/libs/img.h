@@ -13,6 +13,10 @@
  *  - https://www.boost.org/doc/libs/1_76_0/libs/geometry/doc/html/geometry/spatial_indexes/rtree_examples.html
  *  - https://github.com/boostorg/geometry/tree/develop/example
  *
+ * References for the distance transform:
+ *  - P. F. Felzenszwalb and D. P. Huttenlocher, Theory of Computing 8, 415-428 (2012),
+ *    https://doi.org/10.4086/toc.2012.v008a019
+ *
  * ----------------------------------------------------------------------------
  * TAS-Paths (part of the Takin software suite)
  * Copyright (C) 2021       Tobias WEBER (Institut Laue-Langevin (ILL),
@@ -46,7 +50,12 @@
 
 #include <concepts>
 #include <vector>
+#include <optional>
+#include <limits>
+#include <algorithm>
 #include <cstdlib>
+#include <cstdint>
+#include <cmath>
 
 #ifdef USE_GIL
 	#include <boost/gil/image.hpp>
@@ -641,6 +650,318 @@ build_closest_pixel_tree(const t_imageview& img)
 	return results;
 #endif
 }
+
+
+/**
+ * results structure of the build_closest_pixel_map function,
+ * contains the closest set pixel for every pixel of the image
+ */
+template<class t_vec>
+requires tl2::is_vec<t_vec>
+class ClosestPixelMapResults
+{
+public:
+	using t_scalar = typename t_vec::value_type;
+	using t_index = std::uint32_t;
+
+	// marker for pixels without any set pixel in the image
+	static constexpr t_index no_pixel = std::numeric_limits<t_index>::max();
+
+
+public:
+	/**
+	 * allocate the map for an image with the given dimensions
+	 */
+	void Init(std::size_t width, std::size_t height)
+	{
+		m_width = width;
+		m_height = height;
+		m_closest.assign(width * height, no_pixel);
+	}
+
+
+	/**
+	 * clear the map
+	 */
+	void Clear()
+	{
+		m_width = m_height = 0;
+		m_closest.clear();
+		m_closest.shrink_to_fit();
+	}
+
+
+	std::size_t GetWidth() const { return m_width; }
+	std::size_t GetHeight() const { return m_height; }
+
+
+	/**
+	 * get and set the linear index of the closest set pixel
+	 */
+	t_index GetClosestIndex(std::size_t x, std::size_t y) const
+	{
+		return m_closest[y*m_width + x];
+	}
+
+	void SetClosestIndex(std::size_t x, std::size_t y, t_index idx)
+	{
+		m_closest[y*m_width + x] = idx;
+	}
+
+
+	/**
+	 * query the set pixel closest to pos,
+	 * positions outside the image are clamped to its borders
+	 */
+	std::optional<t_vec> Query(const t_vec& pos) const
+	{
+		if(m_closest.empty())
+			return std::nullopt;
+
+		std::size_t x = static_cast<std::size_t>(std::clamp<t_scalar>(
+			pos[0], 0, static_cast<t_scalar>(m_width - 1)));
+		std::size_t y = static_cast<std::size_t>(std::clamp<t_scalar>(
+			pos[1], 0, static_cast<t_scalar>(m_height - 1)));
+
+		t_index idx = GetClosestIndex(x, y);
+		if(idx == no_pixel)
+			return std::nullopt;
+
+		return tl2::create<t_vec>({
+			static_cast<t_scalar>(idx % m_width),
+			static_cast<t_scalar>(idx / m_width) });
+	}
+
+
+private:
+	std::size_t m_width{}, m_height{};
+
+	// linear indices of the closest set pixels
+	std::vector<t_index> m_closest{};
+};
+
+
+/**
+ * find the closest set pixel for every pixel of the image using an
+ * exact euclidean distance transform, which runs in linear time
+ * @arg weight_x, weight_y scale the pixel distances for an anisotropic metric
+ * @see (Felzenszwalb 2012), https://doi.org/10.4086/toc.2012.v008a019
+ */
+template<class t_vec, class t_imageview>
+requires tl2::is_vec<t_vec>
+ClosestPixelMapResults<t_vec>
+build_closest_pixel_map(const t_imageview& img,
+	double weight_x = 1., double weight_y = 1.)
+{
+	using t_results = ClosestPixelMapResults<t_vec>;
+	using t_index = typename t_results::t_index;
+
+	t_results results;
+	auto [width, height] = get_image_dims(img);
+	if(!width || !height)
+		return results;
+	results.Init(width, height);
+
+	const int w = static_cast<int>(width);
+	const int h = static_cast<int>(height);
+
+	// first pass: closest set pixel within each column, -1 if none
+	std::vector<int> closest_row(width * height, -1);
+
+	for(int x=0; x<w; ++x)
+	{
+		// closest set pixel above
+		int last_row = -1;
+		for(int y=0; y<h; ++y)
+		{
+			// use the same pixel positions as the index tree
+			if(get_pixel(img, x-1, y))
+				last_row = y;
+			closest_row[y*w + x] = last_row;
+		}
+
+		// closest set pixel below
+		last_row = -1;
+		for(int y=h-1; y>=0; --y)
+		{
+			if(get_pixel(img, x-1, y))
+				last_row = y;
+
+			int& row = closest_row[y*w + x];
+			if(last_row >= 0 && (row < 0 || last_row - y < y - row))
+				row = last_row;
+		}
+	}
+
+	// second pass: lower envelope of the parabolas centred at the column results,
+	// the distances are measured in units of weight_x
+	const double aspect_sq = (weight_y * weight_y) / (weight_x * weight_x);
+
+	std::vector<double> dist_sq(width);
+	std::vector<int> parabola_x(width);
+	std::vector<double> parabola_bounds(width + 1);
+
+	for(int y=0; y<h; ++y)
+	{
+		const int *row = closest_row.data() + y*w;
+
+		// squared column distances
+		for(int x=0; x<w; ++x)
+		{
+			if(row[x] >= 0)
+				dist_sq[x] = aspect_sq * double(row[x] - y) * double(row[x] - y);
+		}
+
+		// intersection of the parabolas centred at x1 and x2
+		auto intersect = [&dist_sq](int x1, int x2) -> double
+		{
+			return ((dist_sq[x2] + double(x2)*double(x2)) - (dist_sq[x1] + double(x1)*double(x1)))
+				/ double(2*(x2 - x1));
+		};
+
+		int num_parabolas = 0;
+		for(int x=0; x<w; ++x)
+		{
+			if(row[x] < 0)
+				continue;
+
+			double bound = -std::numeric_limits<double>::infinity();
+			while(num_parabolas > 0)
+			{
+				bound = intersect(parabola_x[num_parabolas - 1], x);
+				if(bound > parabola_bounds[num_parabolas - 1])
+					break;
+
+				// the previous parabola is hidden by the current one
+				--num_parabolas;
+				bound = -std::numeric_limits<double>::infinity();
+			}
+
+			parabola_x[num_parabolas] = x;
+			parabola_bounds[num_parabolas] = bound;
+			parabola_bounds[num_parabolas + 1] = std::numeric_limits<double>::infinity();
+			++num_parabolas;
+		}
+
+		// no set pixels in the image
+		if(num_parabolas == 0)
+			continue;
+
+		// evaluate the lower envelope
+		int parabola_idx = 0;
+		for(int x=0; x<w; ++x)
+		{
+			while(parabola_bounds[parabola_idx + 1] < double(x))
+				++parabola_idx;
+
+			int closest_x = parabola_x[parabola_idx];
+			int closest_y = row[closest_x];
+			results.SetClosestIndex(x, y, static_cast<t_index>(closest_y*w + closest_x));
+		}
+	}
+
+	return results;
+}
+// ----------------------------------------------------------------------------
+
+
+/**
+ * visit the pixels crossed by the line segment from pos1 to pos2 in order,
+ * using a digital differential analyser; pixels only touched at a corner are
+ * also included (supercover), so that no diagonal gaps occur
+ * @arg cell_size size of the grid cells to traverse, 1 for pixels
+ * @arg t_start, t_end range of the line parameter to traverse
+ * @arg visit function called with the cell coordinates and the line parameter
+ *      range inside the cell, returns true to stop the traversal
+ * @returns true if the traversal has been stopped by the visitor
+ */
+template<class t_vec, class t_visitor>
+requires tl2::is_vec<t_vec>
+bool traverse_line_pixels(const t_vec& pos1, const t_vec& pos2, t_visitor&& visit,
+	typename t_vec::value_type cell_size = 1,
+	typename t_vec::value_type t_start = 0,
+	typename t_vec::value_type t_end = 1)
+{
+	using t_real = typename t_vec::value_type;
+	constexpr const t_real inf = std::numeric_limits<t_real>::infinity();
+
+	// tolerance for detecting lines through cell corners
+	constexpr const t_real corner_eps = 1e-10;
+
+	// line direction in units of the cell size
+	const t_real dir[2] = { (pos2[0] - pos1[0]) / cell_size, (pos2[1] - pos1[1]) / cell_size };
+	const t_real start[2] = { pos1[0] / cell_size + t_start*dir[0], pos1[1] / cell_size + t_start*dir[1] };
+	const t_real end[2] = { pos1[0] / cell_size + t_end*dir[0], pos1[1] / cell_size + t_end*dir[1] };
+
+	long cell[2] = { long(std::floor(start[0])), long(std::floor(start[1])) };
+	const long end_cell[2] = { long(std::floor(end[0])), long(std::floor(end[1])) };
+
+	// line parameter at the next cell boundary and the distance between boundaries
+	long step[2]{};
+	t_real t_max[2]{}, t_delta[2]{};
+	for(int i=0; i<2; ++i)
+	{
+		if(dir[i] > 0)
+		{
+			step[i] = 1;
+			t_delta[i] = t_real(1) / dir[i];
+			t_max[i] = t_start + (t_real(cell[i] + 1) - start[i]) / dir[i];
+		}
+		else if(dir[i] < 0)
+		{
+			step[i] = -1;
+			t_delta[i] = -t_real(1) / dir[i];
+			t_max[i] = t_start + (t_real(cell[i]) - start[i]) / dir[i];
+		}
+		else
+		{
+			t_delta[i] = t_max[i] = inf;
+		}
+	}
+
+	// number of cells on the way
+	const long max_steps = std::abs(end_cell[0] - cell[0]) + std::abs(end_cell[1] - cell[1]);
+
+	t_real t_enter = t_start;
+	for(long cur_step=0; ; ++cur_step)
+	{
+		t_real t_exit = std::min(std::min(t_max[0], t_max[1]), t_end);
+		if(visit(cell[0], cell[1], t_enter, t_exit))
+			return true;
+
+		if((cell[0] == end_cell[0] && cell[1] == end_cell[1]) || cur_step >= max_steps)
+			break;
+
+		if(t_max[0] < t_max[1] - corner_eps)
+		{
+			cell[0] += step[0];
+			t_enter = t_max[0];
+			t_max[0] += t_delta[0];
+		}
+		else if(t_max[1] < t_max[0] - corner_eps)
+		{
+			cell[1] += step[1];
+			t_enter = t_max[1];
+			t_max[1] += t_delta[1];
+		}
+		else
+		{
+			// the line passes exactly through a corner, include both adjacent cells
+			t_enter = t_max[0];
+			if(visit(cell[0] + step[0], cell[1], t_enter, t_enter) ||
+				visit(cell[0], cell[1] + step[1], t_enter, t_enter))
+				return true;
+
+			cell[0] += step[0];
+			cell[1] += step[1];
+			t_max[0] += t_delta[0];
+			t_max[1] += t_delta[1];
+			++cur_step;
+		}
+	}
+
+	return false;
+}
 // ----------------------------------------------------------------------------
 
 } // geo
@@ -38,6 +38,7 @@
 #define __GEO_ALGOS_LINES_H__
 
 #include <vector>
+#include <iterator>
 #include <queue>
 #include <tuple>
 #include <algorithm>
@@ -1602,9 +1603,10 @@ requires tl2::is_vec<t_vec>
 		// if length is greater than requested length, subdivide
 		if(len > dist)
 		{
-			t_real div = std::ceil(len / dist);
-			for(t_real param=1./div; param<1.; param += 1./div)
+			std::size_t div = static_cast<std::size_t>(std::ceil(len / dist));
+			for(std::size_t step=1; step<div; ++step)
 			{
+				t_real param = t_real(step) / t_real(div);
 				t_vec vertBetween = vert0 + param*(vert1 - vert0);
 				newverts.emplace_back(std::move(vertBetween));
 			}
@@ -1654,6 +1656,156 @@ requires tl2::is_vec<t_vec>
 }
 
 
+/**
+ * lazily subdivided line segments of a path:
+ * iterates the vertices of subdivide_lines() without storing them,
+ * optionally also skipping the close vertices like remove_close_vertices()
+ */
+template<class t_vec,
+	class t_real = typename t_vec::value_type,
+	template<class...> class t_cont = std::vector>
+requires tl2::is_vec<t_vec>
+class subdivided_lines
+{
+public:
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = t_vec;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const t_vec*;
+		using reference = const t_vec&;
+
+	public:
+		iterator() = default;
+		iterator(const iterator&) = default;
+		iterator& operator=(const iterator&) = default;
+
+		iterator(const subdivided_lines* lines, std::size_t seg)
+			: m_lines{lines}, m_seg{seg}
+		{
+			if(m_seg < m_lines->m_vertices.size())
+			{
+				SetSegment(m_seg);
+				m_vert = m_lines->m_vertices[m_seg];
+			}
+		}
+
+		reference operator*() const { return m_vert; }
+		pointer operator->() const { return &m_vert; }
+
+		iterator& operator++()
+		{
+			const t_vec last_vert = m_vert;
+
+			while(Next())
+			{
+				// always keep the last vertex and the ones far enough from the previous one
+				if(!m_lines->m_remove_close || IsLast() ||
+					tl2::norm<t_vec>(m_vert - last_vert) >= m_lines->m_dist)
+					break;
+			}
+
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			iterator iter = *this;
+			this->operator++();
+			return iter;
+		}
+
+		bool operator==(const iterator& iter) const
+		{ return m_seg == iter.m_seg && m_step == iter.m_step; }
+
+		bool operator!=(const iterator& iter) const
+		{ return !this->operator==(iter); }
+
+	protected:
+		// set up the subdivision of the segment starting at the given vertex
+		void SetSegment(std::size_t seg)
+		{
+			m_seg = seg;
+			m_step = 0;
+			m_div = 1;
+
+			const auto& vertices = m_lines->m_vertices;
+			if(m_seg + 1 >= vertices.size())
+				return;
+
+			t_real len = tl2::norm<t_vec>(vertices[m_seg + 1] - vertices[m_seg]);
+			if(len > m_lines->m_dist)
+				m_div = static_cast<std::size_t>(std::ceil(len / m_lines->m_dist));
+		}
+
+		// go to the next subdivided vertex, returns false at the end
+		bool Next()
+		{
+			const auto& vertices = m_lines->m_vertices;
+
+			if(++m_step >= m_div)
+			{
+				SetSegment(m_seg + 1);
+				if(m_seg >= vertices.size())
+				{
+					m_seg = vertices.size();
+					return false;
+				}
+
+				m_vert = vertices[m_seg];
+			}
+			else
+			{
+				t_real param = t_real(m_step) / t_real(m_div);
+				m_vert = vertices[m_seg] + param*(vertices[m_seg + 1] - vertices[m_seg]);
+			}
+
+			return true;
+		}
+
+		bool IsLast() const
+		{ return m_seg + 1 == m_lines->m_vertices.size(); }
+
+	private:
+		const subdivided_lines* m_lines{};
+
+		// current segment, subdivision step and number of divisions of the segment
+		std::size_t m_seg{};
+		std::size_t m_step{};
+		std::size_t m_div{1};
+
+		// current vertex
+		t_vec m_vert{};
+	};
+
+	using const_iterator = iterator;
+
+
+public:
+	subdivided_lines() = default;
+
+	subdivided_lines(t_cont<t_vec> vertices, t_real dist, bool remove_close = false)
+		: m_vertices{std::move(vertices)}, m_dist{dist}, m_remove_close{remove_close}
+	{}
+
+	iterator begin() const { return iterator(this, 0); }
+	iterator end() const { return iterator(this, m_vertices.size()); }
+
+	bool empty() const { return m_vertices.empty(); }
+
+	// the vertices that are subdivided
+	const t_cont<t_vec>& GetVertices() const { return m_vertices; }
+
+
+private:
+	t_cont<t_vec> m_vertices{};
+	t_real m_dist{1};
+	bool m_remove_close{false};
+};
+
+
 /**
  * arc length of a path
  */
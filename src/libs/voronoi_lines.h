@@ -1197,6 +1197,9 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 	}
 
 
+	// compact the graph now that all edges are known
+	finalise_graph(graph);
+
 	if(regions && regions->GetLineGroups()->size())
 		results.RemoveUnconnectedVertices();
 	results.CreateEdgeMaps();
@@ -1399,6 +1402,7 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 		}
 	}
 
+	finalise_graph(graph);
 	results.CreateIndexTree();
 	return results;
 }
@@ -1772,6 +1776,9 @@ requires tl2::is_vec<t_vec> && is_graph<t_graph>
 	}
 
 
+	// compact the graph now that all edges are known
+	finalise_graph(graph);
+
 	if(regions && regions->GetLineGroups()->size())
 		results.RemoveUnconnectedVertices();
 	results.CreateEdgeMaps();
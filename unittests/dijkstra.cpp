@@ -32,6 +32,8 @@
 #define BOOST_TEST_MODULE test_dijkstra
 
 #include <tuple>
+#include <random>
+#include <cmath>
 
 #include <boost/test/included/unit_test.hpp>
 #include <boost/type_index.hpp>
@@ -42,9 +44,10 @@ namespace ty = boost::typeindex;
 
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
-	decltype(std::tuple<                      // test dijkstra's algorithm using both an
-		geo::AdjacencyMatrix<unsigned int>,   // adjacency matrix, and
-		geo::AdjacencyList<unsigned int>>{})) // an adjacency list
+	decltype(std::tuple<                      // test dijkstra's algorithm using an
+		geo::AdjacencyMatrix<unsigned int>,   // adjacency matrix,
+		geo::AdjacencyList<unsigned int>,     // an adjacency list, and
+		geo::CompressedAdjacencyList<unsigned int>>{})) // a compressed adjacency list
 {
 	// create a graph
 	t_graph graph;
@@ -67,6 +70,7 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
 	graph.AddEdge("v3", "v5", 2);
 	graph.AddEdge("v4", "v2", 1);
 	graph.AddEdge("v4", "v5", 2);
+	geo::finalise_graph(graph);
 
 	//print_graph<t_graph>(graph, std::cout);
 
@@ -107,4 +111,205 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(dijkstra, t_graph,
 		if(predecessors[i] && expected_predecessors[i])
 			BOOST_TEST((*predecessors[i] == *expected_predecessors[i]));
 	}
+
+	// verify the distances from the start vertex, i.e. the costs of the shortest-path tree
+	using t_weight_func = std::optional<unsigned int>(std::size_t, std::size_t);
+	std::vector<unsigned int> dists;
+	auto predecessors_dists = dijk<t_graph, t_weight_func>(graph, "v1", nullptr, &dists);
+	BOOST_TEST((predecessors_dists == predecessors));
+
+	const std::vector<unsigned int> expected_dists{{ 0, 1, 4, 5, 6 }};
+	BOOST_TEST((dists == expected_dists));
+}
+
+
+BOOST_AUTO_TEST_CASE(compressed_graph)
+{
+	using t_graph = geo::CompressedAdjacencyList<unsigned int>;
+	using t_graph_ref = geo::AdjacencyList<unsigned int>;
+
+	t_graph graph;
+	t_graph_ref graph_ref;
+
+	for(const char* vert : { "v1", "v2", "v3", "v4" })
+	{
+		graph.AddVertex(vert);
+		graph_ref.AddVertex(vert);
+	}
+
+	auto add_edge = [&graph, &graph_ref](const char* vert1, const char* vert2, unsigned int w)
+	{
+		graph.AddEdge(vert1, vert2, w);
+		graph_ref.AddEdge(vert1, vert2, w);
+	};
+
+	auto compare = [&graph, &graph_ref]()
+	{
+		BOOST_TEST((graph.GetNumVertices() == graph_ref.GetNumVertices()));
+		for(std::size_t i=0; i<graph.GetNumVertices(); ++i)
+		{
+			BOOST_TEST((graph.GetVertexIdent(i) == graph_ref.GetVertexIdent(i)));
+			BOOST_TEST((*graph.GetVertexIndex(graph.GetVertexIdent(i)) == i));
+
+			for(std::size_t j=0; j<graph.GetNumVertices(); ++j)
+				BOOST_TEST((graph.GetWeight(i, j) == graph_ref.GetWeight(i, j)));
+		}
+	};
+
+	// edges before and after compaction
+	add_edge("v1", "v2", 1);
+	add_edge("v2", "v3", 2);
+	compare();
+	graph.Finalise();
+	compare();
+
+	// the most recently added edge overrides the previous one
+	add_edge("v3", "v4", 3);
+	add_edge("v1", "v2", 5);
+	compare();
+	graph.Finalise();
+	compare();
+	BOOST_TEST((graph.GetNeighbours(0).size() == 1));
+
+	graph.SetWeight("v3", "v4", 7);
+	graph_ref.SetWeight("v3", "v4", 7);
+	compare();
+
+	// removal of edges and vertices
+	graph.RemoveEdge("v2", "v3");
+	graph_ref.RemoveEdge("v2", "v3");
+	compare();
+
+	add_edge("v4", "v2", 4);
+	graph.RemoveVertex("v3");
+	graph_ref.RemoveVertex("v3");
+	compare();
+	BOOST_TEST((graph.GetNeighbours("v2", false) == std::vector<std::string>{ "v1", "v4" }));
+}
+
+
+BOOST_AUTO_TEST_CASE(goal_directed_search)
+{
+	using t_real = double;
+	using t_graph = geo::CompressedAdjacencyList<t_real>;
+
+	std::mt19937 rng{std::random_device{}()};
+	std::uniform_real_distribution<t_real> dist_pos(0., 100.);
+
+	for(std::size_t test=0; test<20; ++test)
+	{
+		// random vertex positions
+		const std::size_t N = 200;
+		std::vector<std::pair<t_real, t_real>> positions;
+		t_graph graph;
+		for(std::size_t i=0; i<N; ++i)
+		{
+			positions.emplace_back(dist_pos(rng), dist_pos(rng));
+			graph.AddVertex(std::to_string(i));
+		}
+
+		auto get_dist = [&positions](std::size_t idx1, std::size_t idx2) -> t_real
+		{
+			return std::hypot(positions[idx1].first - positions[idx2].first,
+				positions[idx1].second - positions[idx2].second);
+		};
+
+		// connect close vertices, the edge weights are at least the euclidean distances
+		for(std::size_t i=0; i<N; ++i)
+		{
+			for(std::size_t j=i+1; j<N; ++j)
+			{
+				t_real dist = get_dist(i, j);
+				if(dist > 15.)
+					continue;
+
+				dist *= std::uniform_real_distribution<t_real>(1., 1.5)(rng);
+				graph.AddEdge(i, j, dist);
+				graph.AddEdge(j, i, dist);
+			}
+		}
+		geo::finalise_graph(graph);
+
+		// get the path length from the predecessors
+		auto get_path_length = [&graph](const std::vector<std::optional<std::size_t>>& predecessors,
+			std::size_t startidx, std::size_t goalidx) -> std::optional<t_real>
+		{
+			t_real len = 0.;
+			std::size_t idx = goalidx;
+			for(std::size_t step=0; idx != startidx; ++step)
+			{
+				if(step > graph.GetNumVertices() || !predecessors[idx])
+					return std::nullopt;
+
+				len += *graph.GetWeight(*predecessors[idx], idx);
+				idx = *predecessors[idx];
+			}
+			return len;
+		};
+
+		const std::size_t startidx = 0;
+		const std::size_t goalidx = N - 1;
+		const std::string& start = graph.GetVertexIdent(startidx);
+		const std::string& goal = graph.GetVertexIdent(goalidx);
+
+		auto heuristic = [&get_dist, goalidx](std::size_t idx) -> t_real
+		{
+			return get_dist(idx, goalidx);
+		};
+
+		auto len_dijk = get_path_length(geo::dijk(graph, start), startidx, goalidx);
+		auto len_astar = get_path_length(geo::astar(graph, start, goal, &heuristic), startidx, goalidx);
+		auto len_bidir = get_path_length(geo::dijk_bidir(graph, start, goal), startidx, goalidx);
+
+		BOOST_TEST((len_dijk.has_value() == len_astar.has_value()));
+		BOOST_TEST((len_dijk.has_value() == len_bidir.has_value()));
+		if(len_dijk && len_astar && len_bidir)
+		{
+			BOOST_TEST(*len_astar == *len_dijk, boost::test_tools::tolerance(1e-8));
+			BOOST_TEST(*len_bidir == *len_dijk, boost::test_tools::tolerance(1e-8));
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(indexed_heap)
+{
+	std::mt19937 rng{std::random_device{}()};
+	std::uniform_int_distribution<int> dist_key(0, 1000);
+
+	const std::size_t N = 500;
+	geo::IndexedHeap<int> heap(N);
+	std::vector<int> keys(N);
+
+	for(std::size_t idx=0; idx<N; ++idx)
+	{
+		keys[idx] = dist_key(rng);
+		heap.Push(idx, keys[idx]);
+	}
+
+	// change the keys of some elements
+	for(std::size_t i=0; i<N; ++i)
+	{
+		std::size_t idx = std::uniform_int_distribution<std::size_t>(0, N-1)(rng);
+		keys[idx] = dist_key(rng);
+		heap.Push(idx, keys[idx]);
+	}
+	BOOST_TEST((heap.Size() == N));
+
+	// the elements have to come out sorted by their keys
+	int last_key = std::numeric_limits<int>::lowest();
+	std::vector<bool> seen(N, false);
+	while(!heap.Empty())
+	{
+		int key = heap.TopKey();
+		std::size_t idx = heap.Pop();
+
+		BOOST_TEST((key == keys[idx]));
+		BOOST_TEST((key >= last_key));
+		BOOST_TEST((!seen[idx]));
+		BOOST_TEST((!heap.Contains(idx)));
+
+		seen[idx] = true;
+		last_key = key;
+	}
 }
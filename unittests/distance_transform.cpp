@@ -0,0 +1,115 @@
+/**
+ * testing the closest pixel map calculated by the distance transform
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * References:
+ *  * https://www.boost.org/doc/libs/1_76_0/libs/test/doc/html/index.html
+ *
+ * g++ -I.. -Wall -Wextra -Weffc++ -std=c++20 -o distance_transform distance_transform.cpp
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#define BOOST_TEST_MODULE test_distance_transform
+
+#include <boost/test/included/unit_test.hpp>
+namespace test = boost::unit_test;
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cmath>
+
+#include "src/libs/img.h"
+
+
+BOOST_AUTO_TEST_CASE(distance_transform)
+{
+	using t_vec = tl2::vec<int, std::vector>;
+	using t_image = geo::Image<std::uint8_t>;
+
+	std::mt19937 rng{std::random_device{}()};
+
+	for(std::size_t test=0; test<10; ++test)
+	{
+		// create a random image with a varying fraction of set pixels
+		const std::size_t width = std::uniform_int_distribution<std::size_t>(1, 64)(rng);
+		const std::size_t height = std::uniform_int_distribution<std::size_t>(1, 64)(rng);
+		const double fill = std::uniform_real_distribution<double>(0., 0.1)(rng);
+
+		// use an isotropic metric for the first tests and an anisotropic one afterwards
+		const double weight_x = test < 5 ? 1. : std::uniform_real_distribution<double>(0.2, 5.)(rng);
+		const double weight_y = test < 5 ? 1. : std::uniform_real_distribution<double>(0.2, 5.)(rng);
+
+		t_image img(width, height);
+		std::vector<t_vec> set_pixels;
+
+		for(std::size_t y=0; y<height; ++y)
+		{
+			for(std::size_t x=0; x<width; ++x)
+			{
+				bool set = std::uniform_real_distribution<double>(0., 1.)(rng) < fill;
+				img.SetPixel(x, y, set ? 0xff : 0x00);
+
+				// same pixel positions as in the index tree
+				if(set && x+1 < width)
+					set_pixels.emplace_back(tl2::create<t_vec>({int(x + 1), int(y)}));
+			}
+		}
+
+		std::cout << "Testing " << width << " x " << height << " image with "
+			<< set_pixels.size() << " set pixels and metric ("
+			<< weight_x << ", " << weight_y << ")." << std::endl;
+
+		auto results = geo::build_closest_pixel_map<t_vec>(img, weight_x, weight_y);
+
+		// weighted squared distance between two pixels
+		auto get_dist_sq = [weight_x, weight_y](const t_vec& pix1, const t_vec& pix2) -> double
+		{
+			double dx = weight_x * double(pix2[0] - pix1[0]);
+			double dy = weight_y * double(pix2[1] - pix1[1]);
+			return dx*dx + dy*dy;
+		};
+
+		for(std::size_t y=0; y<height; ++y)
+		{
+			for(std::size_t x=0; x<width; ++x)
+			{
+				t_vec pos = tl2::create<t_vec>({int(x), int(y)});
+				std::optional<t_vec> closest = results.Query(pos);
+
+				if(set_pixels.size() == 0)
+				{
+					BOOST_TEST(!closest);
+					continue;
+				}
+
+				// brute-force search for the closest distance
+				double min_dist_sq = std::numeric_limits<double>::max();
+				for(const t_vec& pix : set_pixels)
+					min_dist_sq = std::min(min_dist_sq, get_dist_sq(pix, pos));
+
+				BOOST_TEST((closest && img.GetPixel((*closest)[0] - 1, (*closest)[1])));
+				BOOST_TEST(std::abs(get_dist_sq(*closest, pos) - min_dist_sq) < 1e-6);
+			}
+		}
+	}
+}
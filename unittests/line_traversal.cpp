@@ -0,0 +1,120 @@
+/**
+ * testing the traversal of pixels along a line
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * References:
+ *  * https://www.boost.org/doc/libs/1_76_0/libs/test/doc/html/index.html
+ *
+ * g++ -I.. -Wall -Wextra -Weffc++ -std=c++20 -o line_traversal line_traversal.cpp
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#define BOOST_TEST_MODULE test_line_traversal
+
+#include <boost/test/included/unit_test.hpp>
+namespace test = boost::unit_test;
+
+#include <set>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cmath>
+
+#include "src/libs/img.h"
+
+
+BOOST_AUTO_TEST_CASE(line_traversal)
+{
+	using t_real = double;
+	using t_vec = tl2::vec<t_real, std::vector>;
+
+	constexpr const std::size_t width = 100;
+	constexpr const std::size_t height = 70;
+
+	std::mt19937 rng{std::random_device{}()};
+	std::uniform_real_distribution<t_real> dist_x(0., t_real(width) - 1e-3);
+	std::uniform_real_distribution<t_real> dist_y(0., t_real(height) - 1e-3);
+
+	for(std::size_t test=0; test<1000; ++test)
+	{
+		t_vec pos1 = tl2::create<t_vec>({ dist_x(rng), dist_y(rng) });
+		t_vec pos2 = tl2::create<t_vec>({ dist_x(rng), dist_y(rng) });
+
+		// snap some of the lines to pixel corners and to horizontal or vertical lines
+		if(test % 4 == 1)
+		{
+			pos1 = tl2::create<t_vec>({ std::floor(pos1[0]), std::floor(pos1[1]) });
+			pos2 = tl2::create<t_vec>({ std::floor(pos2[0]), std::floor(pos2[1]) });
+		}
+		else if(test % 4 == 2)
+		{
+			pos2[1] = pos1[1];
+		}
+		else if(test % 4 == 3)
+		{
+			pos2[0] = pos1[0];
+		}
+
+		// traversed pixels
+		std::set<std::pair<long, long>> visited;
+		geo::traverse_line_pixels<t_vec>(pos1, pos2,
+			[&visited](long x, long y, t_real, t_real) -> bool
+		{
+			visited.insert(std::make_pair(x, y));
+			return false;
+		});
+
+		// all sampled points on the line have to be in the traversed pixels
+		for(t_real t=0.; t<=1.; t+=1e-4)
+		{
+			t_vec pos = pos1 + t*(pos2 - pos1);
+			BOOST_TEST(visited.contains(std::make_pair(long(std::floor(pos[0])), long(std::floor(pos[1])))));
+		}
+
+		// all traversed pixels have to be touched by the line
+		for(const auto& [x, y] : visited)
+		{
+			// clip the line parameter range to the pixel borders
+			t_real t_min = 0., t_max = 1.;
+			for(int i=0; i<2; ++i)
+			{
+				t_real lower = t_real(i == 0 ? x : y) - 1e-6;
+				t_real upper = t_real(i == 0 ? x : y) + 1. + 1e-6;
+				t_real dir = pos2[i] - pos1[i];
+
+				if(std::abs(dir) < 1e-12)
+				{
+					if(pos1[i] < lower || pos1[i] > upper)
+						t_max = -1.;
+					continue;
+				}
+
+				t_real t1 = (lower - pos1[i]) / dir;
+				t_real t2 = (upper - pos1[i]) / dir;
+				t_min = std::max(t_min, std::min(t1, t2));
+				t_max = std::min(t_max, std::max(t1, t2));
+			}
+
+			BOOST_TEST(t_min <= t_max);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/**
+ * testing the lazy subdivision of path line segments
+ * @author Tobias Weber <tweber@ill.fr>
+ * @date oct-2026
+ * @license GPLv3, see 'LICENSE' file
+ *
+ * References:
+ *  * https://www.boost.org/doc/libs/1_76_0/libs/test/doc/html/index.html
+ *
+ * g++ -I.. -Wall -Wextra -Weffc++ -std=c++20 -o subdivide_lines subdivide_lines.cpp
+ *
+ * ----------------------------------------------------------------------------
+ * TAS-Paths (part of the Takin software suite)
+ * Copyright (C) 2021  Tobias WEBER (Institut Laue-Langevin (ILL),
+ *                     Grenoble, France).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * ----------------------------------------------------------------------------
+ */
+
+#define BOOST_TEST_MODULE test_subdivide_lines
+
+#include <boost/test/included/unit_test.hpp>
+namespace test = boost::unit_test;
+
+#include <vector>
+#include <random>
+#include <iostream>
+
+#include "src/libs/lines.h"
+
+
+BOOST_AUTO_TEST_CASE(subdivide_lines)
+{
+	using t_real = double;
+	using t_vec = tl2::vec<t_real, std::vector>;
+
+	std::mt19937 rng{std::random_device{}()};
+	std::uniform_real_distribution<t_real> dist_pos(-10., 10.);
+	std::uniform_real_distribution<t_real> dist_len(0.05, 2.);
+	std::uniform_int_distribution<std::size_t> dist_num(0, 20);
+
+	for(std::size_t test=0; test<1000; ++test)
+	{
+		// random path
+		std::vector<t_vec> vertices;
+		std::size_t num_verts = dist_num(rng);
+		for(std::size_t idx=0; idx<num_verts; ++idx)
+			vertices.emplace_back(tl2::create<t_vec>({ dist_pos(rng), dist_pos(rng) }));
+
+		// some paths with close vertices
+		if(test % 2 == 1 && vertices.size())
+		{
+			vertices.insert(vertices.begin() + vertices.size()/2,
+				vertices[vertices.size()/2] + tl2::create<t_vec>({ 1e-3, 0. }));
+		}
+
+		const t_real len = dist_len(rng);
+
+		for(bool remove_close : { false, true })
+		{
+			std::vector<t_vec> subdivided = geo::subdivide_lines<t_vec>(vertices, len);
+			if(remove_close)
+				subdivided = geo::remove_close_vertices<t_vec>(subdivided, len);
+
+			geo::subdivided_lines<t_vec> lazy(vertices, len, remove_close);
+			std::vector<t_vec> lazy_subdivided(lazy.begin(), lazy.end());
+
+			BOOST_TEST((lazy_subdivided.size() == subdivided.size()));
+			if(lazy_subdivided.size() != subdivided.size())
+				continue;
+
+			for(std::size_t idx=0; idx<subdivided.size(); ++idx)
+				BOOST_TEST((tl2::equals<t_vec>(lazy_subdivided[idx], subdivided[idx], 1e-8)));
+		}
+	}
+}